@@ -3,16 +3,70 @@
 #include <errno.h>
 #include <stdio.h>
 #include <string.h>
+#include <ctype.h>
+
+#if defined(__AVR__)
+//Counters kept by the core's timer0 overflow interrupt (wiring.c)
+extern volatile unsigned long timer0_millis;
+extern volatile unsigned long timer0_overflow_count;
+#define DEBUG_OVERFLOW_MICROS clockCyclesToMicroseconds(64 * 256)
+#endif
 //Todo:
 //Error messages are repeated, only calling method should display error messages
 //Create menu bar
 
 //Create a monitor("point name") method which can display variables in a terminal
 // with a constant refresh
-ArduinoDebugger::ArduinoDebugger(bool isAvr, bool usingTerminal)
+
+//Built-in watch table, only linked into sketches that don't give the debugger one
+static Variable builtin_watches[DEBUG_WATCHES];
+static ArduinoDebugger* builtin_owner = NULL;
+
+ArduinoDebugger::ArduinoDebugger(bool isAvr, bool usingTerminal, bool usingProtocol) : _protocol(_out)
+{
+	if(builtin_owner == NULL)
+	{
+		builtin_owner = this;
+		init(builtin_watches, DEBUG_WATCHES, isAvr, usingTerminal, usingProtocol);
+	}
+	else
+	{//Another debugger is using the table, this one can't watch anything
+		init(NULL, 0, isAvr, usingTerminal, usingProtocol);
+	}
+}
+
+ArduinoDebugger::ArduinoDebugger(ArduinoDebugger &&other) : _protocol(_out)
+{
+	*this = other;//_protocol keeps writing to this debugger's _out
+	if(builtin_owner == &other)
+	{
+		builtin_owner = this;
+	}
+	other._watches = NULL;
+	other._watch_capacity = 0;
+	other.top_var_watch = 0;
+	other._free_watch = DEBUG_NO_WATCH;
+}
+
+ArduinoDebugger::~ArduinoDebugger()
+{
+	if(builtin_owner == this)
+	{
+		builtin_owner = NULL;
+	}
+}
+
+void ArduinoDebugger::init(Variable watches[], byte capacity, bool isAvr, bool usingTerminal, bool usingProtocol)
 {
+	_watches = watches;
+	_watch_capacity = capacity;
 	_isAvr = isAvr;
 	_usingTerminal = usingTerminal;
+	_usingProtocol = usingProtocol;
+	memset(&_pins, 0, sizeof(_pins));
+	memset(_analog, 0, sizeof(_analog));
+	static const byte break_frame[] = {DEBUG_FRAME_SYNC, 0, OP_BREAK, (byte)(0 - OP_BREAK)};
+	setBreakSequence(break_frame, sizeof(break_frame));
 }
 
 /**********************************************************
@@ -22,9 +76,8 @@ ArduinoDebugger::ArduinoDebugger(bool isAvr, bool usingTerminal)
 *  so that they can view & update the systems:
 *			-Pins
 *			-Watched Variables
-*	 This method also saves the value of the millis() when the method was called.
-*  Upon exiting the breakpoint method, millis() will be returned to its previous value (as long as
-*  millis() wasn't updated by the user).
+*	 The time spent halted is recorded (see haltedTime()) and, with
+*  setTimeCompensation(true), taken off millis() & micros() on exit.
 ***********************************************************/
 void ArduinoDebugger::breakpoint()
 {
@@ -38,23 +91,46 @@ void ArduinoDebugger::breakpoint()
 *  so that they can view & update the systems:
 *			-Pins
 *			-Watched Variables
-*			-Millis() Timer 
 *	 
-*	@note This method also saves the value of the millis() when the method was called.
-*  Upon exiting the breakpoint method, millis() will be returned to its previous value (as long as
-*  millis() wasn't updated by the user).
+*	@note The time spent halted is recorded (see haltedTime()) and, with
+*  setTimeCompensation(true), taken off millis() & micros() on exit so
+*  timing code carries on as if the program never stopped.
+*	@note When the debugger was created with usingProtocol set, the text menus
+*  are replaced by the binary protocol (see protocolBreakpoint()).
+*	@note While profiling (see profileBegin()) the breakpoint only counts
+*  the hit and the program keeps running.
 *	@param name A string for labeling the breakpoint.  
 ***********************************************************/
 void ArduinoDebugger::breakpoint(char name[])
 {
+	if(_profile.active())
+	{
+		_profile.hit(name);
+		return;
+	}
+	halt(name);
+}
+
+//Run a debugger session (the menus or the binary protocol) until the program continues
+void ArduinoDebugger::halt(char name[])
+{
+	finishReply();//The host gets the rest of an answer poll() started
+	_halt_start = micros();
+	if(_usingProtocol)
+	{//A host tool is driving the debugger
+		protocolBreakpoint(name);
+		_break_in = false;//Asking to break in while stopped is already answered
+		updateTimer();
+		return;
+	}
 	clearScreen();//Clear Screen
 	byte selection;
 	do{
 		//Debugger Menu
-		Serial.print(F("\tBreakpoint - "));
-		Serial.println(name);
-		Serial.println(F("1. Hardware Pins \n2. Variables"));
-		Serial.println(F("What component would you like to view and/or update?"));
+		_out.print(F("\tBreakpoint - "));
+		_out.println(name);
+		_out.println(F("1. Hardware Pins \n2. Variables\n3. Breakpoint Condition"));
+		_out.println(F("What component would you like to view and/or update?"));
 		selection = getSelection();
 		switch(selection)
 		{
@@ -70,97 +146,413 @@ void ArduinoDebugger::breakpoint(char name[])
 				clearScreen();
 				break;
 				
-			case 3://Exit debugging 
-			case 255://Accepts Q 
-			  selection = 3;
-				Serial.println(F("\nContinuing Program"));
+			case 3://3. Set the condition used by breakpointIf()
+				clearScreen();
+				updateCondition();
+				clearScreen();
+				break;
+				
+			case 255://Exit debugging (Accepts Q)
+				_out.println(F("\nContinuing Program"));
+				_out.flush();
 				break;
 				
 			default:
 				clearScreen();
-				Serial.println(F("Invalid Selection"));
+				_out.println(F("Invalid Selection"));
 		}
-	}while(selection != 3);
+	}while(selection != 255);
+	_break_in = false;
+	updateTimer();
+}
+
+#if defined(__AVR__) || defined(DEBUG_MILLIS_COUNTER)
+//Whole units in carry + elapsed, the rest is carried to the next halt
+static unsigned long takeUnits(unsigned int &carry, unsigned long elapsed, unsigned int unit)
+{
+	elapsed += carry;
+	carry = elapsed % unit;
+	return elapsed / unit;
+}
+#endif
+
+/**********************************************************
+* @brief Account for the time spent halted in a breakpoint.
+*
+*  Called as a breakpoint continues.  With time compensation on,
+*  the core's counters are rewound by the length of the halt:
+*  timer0's millisecond & overflow counts on AVR, otherwise
+*  DEBUG_MILLIS_COUNTER (or DEBUG_MICROS_COUNTER).  Time shorter
+*  than a counter's step is carried to the next halt.
+***********************************************************/
+void ArduinoDebugger::updateTimer()
+{
+	unsigned long halt = micros() - _halt_start;
+	_last_halt = halt;
+	_halted += halt;
+	if(!_compensate)
+	{
+		return;
+	}
+#if defined(__AVR__)
+	unsigned long millis_back = takeUnits(_millis_carry, halt, 1000);
+	unsigned long overflows_back = takeUnits(_micros_carry, halt, DEBUG_OVERFLOW_MICROS);
+	noInterrupts();
+	timer0_millis -= millis_back;
+	timer0_overflow_count -= overflows_back;
+	interrupts();
+#elif defined(DEBUG_MILLIS_COUNTER)
+	unsigned long millis_back = takeUnits(_millis_carry, halt, 1000);
+	noInterrupts();
+	DEBUG_MILLIS_COUNTER -= millis_back;
+	interrupts();
+#elif defined(DEBUG_MICROS_COUNTER)
+	noInterrupts();
+	DEBUG_MICROS_COUNTER -= halt;
+	interrupts();
+#endif
+}
+
+//Microseconds spent halted in all breakpoints so far (wraps after ~70 minutes)
+unsigned long ArduinoDebugger::haltedTime()
+{
+	return _halted;
+}
+
+//Microseconds the previous breakpoint was halted for
+unsigned long ArduinoDebugger::lastHaltTime()
+{
+	return _last_halt;
+}
+
+/**********************************************************
+* @brief Choose whether breakpoints take the time spent halted
+*				 off millis() & micros().
+*
+*  Schedulers built on millis() then carry on where they stopped
+*  instead of running all the work they missed at once.
+*
+*	@note Only boards whose timer counters can be reached are supported:
+*  AVR, Teensy & STM32, or any core given DEBUG_MILLIS_COUNTER.
+*	@return false if compensation was requested but isn't supported
+***********************************************************/
+bool ArduinoDebugger::setTimeCompensation(bool enabled)
+{
+#if defined(__AVR__) || defined(DEBUG_MILLIS_COUNTER) || defined(DEBUG_MICROS_COUNTER)
+	_compensate = enabled;
+	_millis_carry = 0;
+	_micros_carry = 0;
+	return true;
+#else
+	_compensate = false;
+	return !enabled;
+#endif
 }
 
 /**********************************************************
 * @brief Add a variable to our watch list.
 *
 *  A watched variable can be viewed or updated via the breakpoint method.  
+*  Prefer add(var, name), which works out the type & array length itself.
 *   
 *	@param ptr The memory location of a variable being watched
 *	@param type This is an Enum representing the variable's data type
+*	@param name	The name of variable being watched, arrays must be 
+*					named varName_SIZE (Ex: pins_20)
+***********************************************************/
+byte ArduinoDebugger::add(void *ptr, Type type, char name[])
+{
+	if(isArray(type) && strchr(name, '_') != NULL)
+	{//The name ends at the '_', the array length follows it
+		return addWatch(ptr, type, getSize(name), name, false, hashName(name, strchr(name, '_') - name, false), true);
+	}
+	return addWatch(ptr, type, 1, name, false, hashName(name, strlen(name), false));
+}
+
+/**********************************************************
+* @brief Add a variable whose type & length are already known.
+*
+*  Only a pointer to the name is kept, so adding costs the same
+*  few bytes of RAM whatever the name's length.  Adding a name
+*  that is already watched only updates where the variable is,
+*  so variables can be added on every pass through loop().
+*
+*	@param ptr The memory location of a variable being watched
+*	@param type This is an Enum representing the variable's data type
+*	@param count The number of elements (1 for non array variables)
 *	@param name	The name of variable being watched
+*	@param in_flash true when name is stored in flash (F())
+*	@param hash hashName() of the name
+*	@param sized true when name is varName_SIZE
+*	@return The watch's id, DEBUG_NO_WATCH if the table is full
 ***********************************************************/
-void ArduinoDebugger::add(void *ptr, Type type, char name[])
+byte ArduinoDebugger::addWatch(void *ptr, Type type, uint16_t count, const char* name, bool in_flash, uint16_t hash, bool sized)
 {
-	if(strlen(name) <= 15)
-	{//Verify name will fit inside a struct's name (char[16])
-		//Todo verify variable has not already been added to the variable
-		//watch to prevent variables from being added over n' over with each loop
-		bool exists = false;
-		for(byte i = 0; i < top_var_watch; i++)
-		{
-			Variable check = var_watch[i];
-			if(strcmp(check.name, name) == 0)
-			{//Variable name found
-				exists = true;
-			}
+	Variable temp;
+	temp.ptr = ptr;
+	temp.name = name;
+	temp.count = count;
+	temp.hash = hash;
+	temp.type = type;
+	temp.flash_name = in_flash;
+	temp.sized_name = sized;
+	byte id = findWatch(name, nameLength(temp), in_flash, hash);
+	if(id != DEBUG_NO_WATCH)
+	{//Already watched
+		Variable &var = _watches[id];
+		var.ptr = ptr;
+		if(var.type != type || var.count != count)
+		{//A different variable with the same name (Ex: a local array of another length)
+			var.type = type;
+			var.count = count;
+			forgetWatch(id);
+			_snapshot.clear();
+			_generation++;
 		}
-		if(!exists)
-		{//Verify the variable has not already been added to the watch list
-			Variable temp = {ptr, type};
-			memcpy(temp.name, name, strlen(name) + 1);
-			if(top_var_watch < sizeof(var_watch)/sizeof(var_watch[0]))
-			{//Check that there is room for an additional variable
-				var_watch[top_var_watch] = temp;
-				top_var_watch += 1;
-			}
-			else
-			{
-				clearScreen();
-				drawStars();
-				Serial.print(F("Can't add "));
-				Serial.println(name);
-				Serial.println(F("Too many variables in watch"));
-				drawStars();
-			}
+		else
+		{
+			_trace.moveChannels(id, ptr);
 		}
+		return id;
+	}
+	if(_free_watch != DEBUG_NO_WATCH)
+	{//Reuse the slot of a removed watch
+		id = _free_watch;
+		_free_watch = _watches[id].count;
+	}
+	else if(top_var_watch < _watch_capacity)
+	{//Check that there is room for an additional variable
+		id = top_var_watch;
+		top_var_watch += 1;
 	}
 	else
 	{
-		Serial.print(name);
-		Serial.println(F("-Name must be <=15 characters"));
+		if(!_usingProtocol)
+		{//Text would corrupt a host's frames, it sees the full table in the TABLE frame
+			clearScreen();
+			drawStars();
+			_out.print(F("Can't add "));
+			printName(temp);
+			_out.println();
+			_out.println(F("Too many variables in watch"));
+			drawStars();
+			_out.flush();
+		}
+		return DEBUG_NO_WATCH;
 	}
+	_watches[id] = temp;
+	_snapshot.clear();//Checksums are laid out by watch
+	_generation++;
+	return id;
 }
 
-void ArduinoDebugger::remove(char var_name[])
+/**********************************************************
+* @brief Look up a watch by name.
+*
+*  Only watches whose hash matches have their names compared.
+*
+*	@param name The name to look for (need not be null terminated)
+*	@param length The number of characters in name
+*	@param in_flash true when name is stored in flash
+*	@param hash hashName() of the name
+***********************************************************/
+byte ArduinoDebugger::findWatch(const char* name, byte length, bool in_flash, uint16_t hash)
 {
-	bool found = false;
 	for(byte i = 0; i < top_var_watch; i++)
 	{
-		Variable temp = var_watch[i];
-		if(!found)
+		if(_watches[i].hash == hash && _watches[i].ptr != NULL &&
+			 (_watches[i].name == name || nameMatches(_watches[i], name, length, in_flash)))
 		{
-			if(strcmp(temp.name, var_name) == 0)
-			{//Variable name found
-				found = true;
-			}
+			return i;
+		}
+	}
+	return DEBUG_NO_WATCH;
+}
+
+byte ArduinoDebugger::find(char var_name[])
+{
+	byte length = strlen(var_name);
+	return findWatch(var_name, length, false, hashName(var_name, length, false));
+}
+
+byte ArduinoDebugger::find(WatchName var_name)
+{
+	return findWatch(var_name.text, strlen_P(var_name.text), true, var_name.hash);
+}
+
+void ArduinoDebugger::remove(char var_name[])
+{
+	removeNamed(var_name, false);
+}
+
+void ArduinoDebugger::remove(const __FlashStringHelper* var_name)
+{
+	removeNamed((const char*)var_name, true);
+}
+
+void ArduinoDebugger::removeNamed(const char* var_name, bool in_flash)
+{
+	byte length = in_flash ? strlen_P(var_name) : strlen(var_name);
+	byte id = findWatch(var_name, length, in_flash, hashName(var_name, length, in_flash));
+	if(id == DEBUG_NO_WATCH && _usingProtocol)
+	{//Nothing to remove, text would corrupt a host's frames
+		return;
+	}
+	else if(id == DEBUG_NO_WATCH)
+	{
+		_out.print(F("Unable to remove "));
+		if(in_flash)
+		{
+			_out.println((const __FlashStringHelper*)var_name);
+		}
+		else
+		{
+			_out.println(var_name);
+		}
+		_out.println(F("It was not listed in the variable watch"));
+		_out.flush();
+		return;
+	}
+	removeWatch(id);
+}
+
+/**********************************************************
+* @brief Stop watching a variable.
+*
+*  The slot is put on the free list for the next add(), the
+*  ids of the other watches don't change.
+*
+*	@param id The id returned by add()
+***********************************************************/
+void ArduinoDebugger::removeWatch(byte id)
+{
+	if(!watching(id))
+	{
+		return;
+	}
+	_watches[id].ptr = NULL;
+	_watches[id].count = _free_watch;
+	_free_watch = id;
+	_snapshot.clear();//Checksums are laid out by watch
+	_generation++;
+	forgetWatch(id);
+}
+
+/**********************************************************
+* @brief Drop the watchpoints, breakpoint condition & trace channels
+*        that read a watch, when it is removed or its type changes.
+***********************************************************/
+void ArduinoDebugger::forgetWatch(byte id)
+{
+	_trace.dropChannels(id);
+	for(byte i = 0; i < _num_watchpoints;)
+	{
+		if(_watchpoints[i].term.index == id)
+		{//Move the last watchpoint into the gap
+			_num_watchpoints--;
+			_watchpoints[i] = _watchpoints[_num_watchpoints];
 		}
 		else
 		{
-			var_watch[i - 1] = temp;//Replace the previous entry
+			i++;
+		}
+	}
+	for(byte i = 0; i < _num_terms; i++)
+	{//The breakpoint condition can't test a variable that's gone
+		if(_terms[i].index == id)
+		{
+			clearCondition();
+		}
+	}
+}
+
+/**********************************************************
+* @brief The watch table's generation.
+*
+*  Adding or removing a watch changes it (pointing a watch at a new
+*  copy of its variable doesn't), so a host that cached the table
+*  knows when to fetch it again.
+***********************************************************/
+byte ArduinoDebugger::generation()
+{
+	return _generation;
+}
+
+/**********************************************************
+* @brief Hash a name, giving the same value as debugHash().
+***********************************************************/
+uint16_t ArduinoDebugger::hashName(const char* text, byte length, bool in_flash)
+{
+	uint16_t hash = 5381;
+	for(byte i = 0; i < length; i++)
+	{
+		byte c = in_flash ? pgm_read_byte(text + i) : text[i];
+		hash = (hash * 33) ^ c;
+	}
+	return hash;
+}
+
+/**********************************************************
+* @brief Read one character of a watch's name.
+*
+*	@return 0 once the end of the name is reached
+***********************************************************/
+char ArduinoDebugger::nameChar(const Variable &var, byte position)
+{
+	char c = var.flash_name ? pgm_read_byte(var.name + position) : var.name[position];
+	if(var.sized_name && c == '_')
+	{//Legacy varName_SIZE
+		return 0;
+	}
+	return c;
+}
+
+byte ArduinoDebugger::nameLength(const Variable &var)
+{
+	byte length = 0;
+	while(length < 255 && nameChar(var, length) != 0)
+	{
+		length++;
+	}
+	return length;
+}
+
+/**********************************************************
+* @brief Compare a watch's name against some text.
+*
+*	@param text The name to look for (need not be null terminated)
+*	@param length The number of characters in text
+*	@param in_flash true when text is stored in flash
+***********************************************************/
+bool ArduinoDebugger::nameMatches(const Variable &var, const char* text, byte length, bool in_flash)
+{
+	for(byte i = 0; i < length; i++)
+	{
+		char c = in_flash ? pgm_read_byte(text + i) : text[i];
+		if(nameChar(var, i) != c)
+		{
+			return false;
+		}
+	}
+	return nameChar(var, length) == 0;
+}
+
+void ArduinoDebugger::printName(const Variable &var)
+{
+	if(var.sized_name)
+	{
+		for(byte i = 0; nameChar(var, i) != 0; i++)
+		{
+			_out.write(nameChar(var, i));
 		}
 	}
-	if(!found)
+	else if(var.flash_name)
 	{
-		Serial.print(F("Unable to remove "));
-		Serial.println(var_name);
-		Serial.println(F("It was not listed in the variable watch"));
+		_out.print((const __FlashStringHelper*)var.name);
 	}
 	else
 	{
-		top_var_watch--;
+		_out.print(var.name);
 	}
 }
 
@@ -179,239 +571,357 @@ void ArduinoDebugger::remove(char var_name[])
 ***********************************************************/
 void ArduinoDebugger::displayPins()
 {
+	readPins(_pins);
 	drawStars();
-	Serial.println(F("\t\tDigital Pin State\n\tPin Number : State(LOW/HIGH/HIGH(Power In)"));
+	_out.println(F("\t\tDigital Pin State\n\tPin Number : State(LOW/HIGH/HIGH(Power In)"));
 	drawStars();
 	for(int i = 0; i < NUM_DIGITAL_PINS; i++)
 	{
-		Serial.print(i);
-		Serial.print(F(" : "));
-		bool power_out = false;
-		volatile void* out;
-		if(_isAvr)
-		{//Use 8 bit values for AVR chips
-			uint8_t bit_val = digitalPinToBitMask(i);
-			out = portOutputRegister(digitalPinToPort(i));
-			bit_val &= *static_cast<volatile uint8_t*>(out);
-			if(bit_val > 0)
-			{
-				power_out = true;
-			}
-		}
-		else
-		{//Non AVR chips (SAMD or NRF [:Bit]) use 32 bit
-			uint32_t bit_val = digitalPinToBitMask(i);
-			out = portOutputRegister(digitalPinToPort(i));
-			bit_val &= *static_cast<volatile uint32_t*>(out);
-			if(bit_val > 0)
-			{
-				power_out = true;
-			}
-		}
-		
-		if(power_out)
-		{//Pin set to HIGH -> Providing Power
-			Serial.println(F("HIGH"));
-		}
-		else if(digitalRead(i) == HIGH)
-		{
-			Serial.println(F("HIGH(Power In)"));
-		}
-		else
-		{
-			Serial.println(F("LOW"));
-		}		
+		printDigitalPin(i);
 	}
 	
 	drawStars();
-	Serial.println(F("\t\tAnalog Pin State\n\tPin Number : Analog Value"));
+	_out.println(F("\t\tAnalog Pin State\n\tPin Number : Analog Value"));
 	drawStars();
 	for(int i = A0; i < NUM_ANALOG_INPUTS + A0; i++)
 	{
-		Serial.print(F("A"));
-		Serial.print(i-A0);
-		Serial.print(F(" : "));
-		Serial.println(analogRead(i));
+		printAnalogPin(i, analogRead(i));
 	}
+	_out.flush();
 }
 
-//Incomplete
-//Update to work with byte arrays & determine their size!
-void ArduinoDebugger::displayPins(byte digital_pins[], byte analog_pins[])
+/**********************************************************
+* @brief Display the current state of a chosen set of pins.
+*
+*	@param digital_pins The digital pins to display
+*	@param num_digital The number of digital pins listed
+*	@param analog_pins The analog pins to display (Ex: A0)
+*	@param num_analog The number of analog pins listed
+***********************************************************/
+void ArduinoDebugger::displayPins(byte digital_pins[], byte num_digital, byte analog_pins[], byte num_analog)
 {
-	Serial.println(F("\t\tDigital Pin State\n\tPin Number : State(LOW/HIGH/HIGH(Power In)"));
+	readPins(_pins);
 	drawStars();
-	for(int i = 0; i < NUM_DIGITAL_PINS; i++)
+	_out.println(F("\t\tDigital Pin State\n\tPin Number : State(LOW/HIGH/HIGH(Power In)"));
+	drawStars();
+	for(byte i = 0; i < num_digital; i++)
 	{
-		Serial.print(i);
-		Serial.println(F(" : "));
-		bool power_out = false;
-		volatile void* out;
-		if(_isAvr)
-		{//Use 8 bit values for AVR chips
-			uint8_t bit_val = digitalPinToBitMask(i);
-			out = portOutputRegister(digitalPinToPort(i));
-			bit_val &= *static_cast<volatile uint8_t*>(out);
-			if(bit_val > 0)
-			{
-				power_out = true;
-			}
-		}
-		else
-		{//Non AVR chips (SAMD or NRF [:Bit]) use 32 bit
-			uint32_t bit_val = digitalPinToBitMask(i);
-			out = portOutputRegister(digitalPinToPort(i));
-			bit_val &= *static_cast<volatile uint32_t*>(out);
-			if(bit_val > 0)
-			{
-				power_out = true;
-			}
-		}
-		
-		if(power_out)
-		{//Pin set to HIGH
-			Serial.println(F("HIGH"));
-		}
-		else if(digitalRead(i) == HIGH)
+		if(digital_pins[i] < NUM_DIGITAL_PINS)
 		{
-			Serial.println(F("HIGH(Power In)"));
+			printDigitalPin(digital_pins[i]);
 		}
-		else
-		{
-			Serial.println(F("LOW"));
-		}		
 	}
 	
 	drawStars();
-	Serial.println(F("\t\tAnalog Pin State\n\tPin Number : Analog Value"));
+	_out.println(F("\t\tAnalog Pin State\n\tPin Number : Analog Value"));
 	drawStars();
-	for(int i = A0; i < NUM_ANALOG_INPUTS + A0; i++)
+	for(byte i = 0; i < num_analog; i++)
+	{
+		if(analog_pins[i] >= A0 && analog_pins[i] < NUM_ANALOG_INPUTS + A0)
+		{
+			printAnalogPin(analog_pins[i], analogRead(analog_pins[i]));
+		}
+	}
+	_out.flush();
+}
+
+/**********************************************************
+* @brief Print one digital pin's state from the latest snapshot.
+***********************************************************/
+void ArduinoDebugger::printDigitalPin(int pin)
+{
+	_out.print(pin);
+	_out.print(F(" : "));
+	if(bitRead(_pins.powered[pin / 8], pin % 8))
+	{//Pin set to HIGH -> Providing Power
+		_out.println(F("HIGH"));
+	}
+	else if(bitRead(_pins.high[pin / 8], pin % 8))
+	{
+		_out.println(F("HIGH(Power In)"));
+	}
+	else
 	{
-		Serial.print(F("A"));
-		Serial.print(i-A0);
-		Serial.print(F(" : "));
-		Serial.println(analogRead(i));
+		_out.println(F("LOW"));
 	}
 }
 
+void ArduinoDebugger::printAnalogPin(int pin, int value)
+{
+	_out.print(F("A"));
+	_out.print(pin - A0);
+	_out.print(F(" : "));
+	_out.println(value);
+	_analog[pin - A0] = value;//Remember the value shown for the change view
+}
 
 /**********************************************************
-* @brief Prompt the user for the value to update the pin to.
-*
-*  This method will prompt the user for the new digital value (HIGH/LOW)
-*  to update the pin to.  
+* @brief Display only the pins that changed since they were last shown.
 *
-*  @note If an invalid value is entered, no change will be made to the pin.
-*  
-*	 @param pin The chosen pin to update
+*  A digital pin is listed when its state (LOW/HIGH/HIGH(Power In))
+*  changed, an analog pin when its value moved by more than the dead-band
+*  set with setPinDelta().  displayPins() still shows every pin.
 ***********************************************************/
-void ArduinoDebugger::updatePins()
+void ArduinoDebugger::displayPinChanges()
 {
-	byte selection = 'Q';
-	displayPins();
-	Serial.println(F("Enter the Pin Number for the Digital Pin to be updated."));
-	byte pin = getSelection();
-	while(pin != 255)
+	PinSnapshot previous = _pins;
+	readPins(_pins);
+	drawStars();
+	_out.println(F("\t\tChanged Pins\n\tPin Number : State/Analog Value"));
+	drawStars();
+	byte changes = 0;
+	for(int i = 0; i < NUM_DIGITAL_PINS; i++)
 	{
-		if(pin < NUM_DIGITAL_PINS && pin != 254)
+		if(pinChanged(previous, i))
 		{
-			Serial.print(F("Set "));
-			Serial.print(pin);
-			Serial.print(F(" to (H)IGH or (L)OW: "));
-			while(Serial.available() == 0){}
-			byte state = Serial.peek();
-			if(!_usingTerminal)
-			{
-				while(Serial.available() != 0)
-				{
-					Serial.print((char)Serial.read());//Echo value back to Serial Monitor
-				}
-			}
-			clearScreen();
-			if(state == 'H' || state == 'h')
-			{
-				digitalWrite(pin, HIGH);
-			}
-			else if(state == 'L' || state == 'l')
-			{
-				digitalWrite(pin, LOW);
-			}
-			else
-			{
-				Serial.println(F("Invalid Value"));
-			}
+			printDigitalPin(i);
+			changes++;
 		}
-		else
+	}
+	for(int i = A0; i < NUM_ANALOG_INPUTS + A0; i++)
+	{
+		int value = analogRead(i);
+		if(abs(value - _analog[i - A0]) > _deadband)
 		{
-			Serial.println(F("Invalid Selection"));
+			printAnalogPin(i, value);
+			changes++;
 		}
-		clearBuffer();
-		displayPins();
-		pin = getSelection();	
 	}
-	drawStars();
+	if(changes == 0)
+	{
+		_out.println(F("No pins changed"));
+	}
+	_out.flush();
 }
 
 /**********************************************************
-* @brief Display all variables being watched with their current values.
+* @brief Choose whether the pin menu shows every pin or only changes.
 *
-*  This method will display each of the variables (w/ their values) 
-*  that have been added to the watch list (via add() method).  This
-*	 method will then allow the user to update any of the watched variables.
-*  
-*	 
+*	@param enabled true to only show pins that changed
+*	@param deadband How far an analog value must move to be shown
 ***********************************************************/
-void ArduinoDebugger::displayVariables()
+void ArduinoDebugger::setPinDelta(bool enabled, int deadband)
 {
-	Serial.println(F("\t\tVariable Watch"));
-	Serial.println(F("[index] variable_name (type) : value"));
-	drawStars();
+	_pin_delta = enabled;
+	_deadband = deadband;
+}
+
+void ArduinoDebugger::displayPinView()
+{
+	if(_pin_delta)
+	{
+		displayPinChanges();
+	}
+	else
+	{
+		displayPins();
+	}
+}
+
+bool ArduinoDebugger::pinChanged(PinSnapshot &previous, int pin)
+{
+	return bitRead(previous.powered[pin / 8], pin % 8) != bitRead(_pins.powered[pin / 8], pin % 8) ||
+		bitRead(previous.high[pin / 8], pin % 8) != bitRead(_pins.high[pin / 8], pin % 8);
+}
+
+/**********************************************************
+* @brief Capture the state of every digital pin.
+*
+*  Each port's output & input registers are read once and shared by
+*  all of the pins on that port, so the snapshot is consistent across
+*  pins and costs far less than a digitalRead() per pin.
+*
+*	@param snapshot Set to the pins providing power (output register)
+*					and the pins reading HIGH (input register)
+***********************************************************/
+void ArduinoDebugger::readPins(PinSnapshot &snapshot)
+{
+	volatile void* ports[DEBUG_MAX_PORTS];
+	uint32_t outputs[DEBUG_MAX_PORTS];
+	uint32_t inputs[DEBUG_MAX_PORTS];
+	byte num_ports = 0;
+	memset(&snapshot, 0, sizeof(snapshot));
+	for(int i = 0; i < NUM_DIGITAL_PINS; i++)
+	{
+		volatile void* out = portOutputRegister(digitalPinToPort(i));
+		byte port = 0;
+		while(port < num_ports && ports[port] != out)
+		{
+			port++;
+		}
+		if(port == num_ports)
+		{//First pin on this port, read its registers
+			volatile void* in = portInputRegister(digitalPinToPort(i));
+			if(port == DEBUG_MAX_PORTS)
+			{//No room left to remember the port, reuse the last slot
+				port--;
+			}
+			else
+			{
+				num_ports++;
+			}
+			ports[port] = out;
+			if(_isAvr)
+			{//Use 8 bit values for AVR chips
+				outputs[port] = *static_cast<volatile uint8_t*>(out);
+				inputs[port] = *static_cast<volatile uint8_t*>(in);
+			}
+			else
+			{//Non AVR chips (SAMD or NRF [:Bit]) use 32 bit
+				outputs[port] = *static_cast<volatile uint32_t*>(out);
+				inputs[port] = *static_cast<volatile uint32_t*>(in);
+			}
+		}
+		uint32_t bit_val = digitalPinToBitMask(i);
+		if(outputs[port] & bit_val)
+		{
+			bitSet(snapshot.powered[i / 8], i % 8);
+		}
+		if(inputs[port] & bit_val)
+		{
+			bitSet(snapshot.high[i / 8], i % 8);
+		}
+	}
+}
+
+/**********************************************************
+* @brief Check whether any digital pin changed.
+*
+*  The pins are compared against the most recent snapshot, taken by the
+*  pin view, the binary protocol or the previous call to pinsChanged().
+*
+*	@return true if any pin's output or input state changed
+***********************************************************/
+bool ArduinoDebugger::pinsChanged()
+{
+	PinSnapshot current;
+	readPins(current);
+	bool changed = memcmp(&current, &_pins, sizeof(current)) != 0;
+	_pins = current;
+	return changed;
+}
+
+/**********************************************************
+* @brief Prompt the user for the value to update the pin to.
+*
+*  This method will prompt the user for the new digital value (HIGH/LOW)
+*  to update the pin to.  
+*
+*  @note If an invalid value is entered, no change will be made to the pin.
+*  
+*	 @param pin The chosen pin to update
+***********************************************************/
+void ArduinoDebugger::updatePins()
+{
+	displayPinView();
+	_out.println(F("Enter the Pin Number for the Digital Pin to be updated (R to refresh all pins)."));
+	byte pin = getSelection("R");
+	while(pin != 255)
+	{
+		if(pin == 253)
+		{//Show every pin
+			clearScreen();
+			displayPins();
+		}
+		else if(pin < NUM_DIGITAL_PINS && pin != 254)
+		{
+			_out.print(F("Set "));
+			_out.print(pin);
+			_out.print(F(" to (H)IGH or (L)OW: "));
+			char input[4];
+			readLine(input, sizeof(input));
+			byte state = input[0];
+			clearScreen();
+			if(state == 'H' || state == 'h')
+			{
+				digitalWrite(pin, HIGH);
+			}
+			else if(state == 'L' || state == 'l')
+			{
+				digitalWrite(pin, LOW);
+			}
+			else
+			{
+				_out.println(F("Invalid Value"));
+			}
+			displayPinView();
+		}
+		else
+		{
+			_out.println(F("Invalid Selection"));
+			displayPinView();
+		}
+		pin = getSelection("R");	
+	}
+	drawStars();
+}
+
+/**********************************************************
+* @brief Display all variables being watched with their current values.
+*
+*  This method will display each of the variables (w/ their values) 
+*  that have been added to the watch list (via add() method).  This
+*	 method will then allow the user to update any of the watched variables.
+*  
+*	 
+***********************************************************/
+void ArduinoDebugger::displayVariables()
+{
+	_out.println(F("\t\tVariable Watch"));
+	_out.println(F("[index] variable_name (type) : value"));
+	drawStars();
 	for(int i =0; i < top_var_watch; i++)
 	{
-		 Variable temp = var_watch[i];
-		 Serial.print(F("["));
-		 Serial.print(i);
-		 Serial.print(F("] "));
+		 if(!watching(i))
+		 {//Slot left by a removed watch
+			 continue;
+		 }
+		 Variable temp = _watches[i];
+		 _out.print(F("["));
+		 _out.print(i);
+		 _out.print(F("] "));
 		 switch(temp.type)
 		 {		
 				case BYTE:
-				  Serial.print(temp.name);
-					Serial.print(F(" (byte): "));
-					Serial.println(*((byte*)temp.ptr));
+				  printName(temp);
+					_out.print(F(" (byte): "));
+					_out.println(*((byte*)temp.ptr));
 					break;
 					
 				case Type::INT:
-					Serial.print(temp.name);
-					Serial.print(F(" (int): "));
-					Serial.println(*((int*)temp.ptr));
+					printName(temp);
+					_out.print(F(" (int): "));
+					_out.println(*((int*)temp.ptr));
 					break;
 			
 				case Type::LONG:
-					Serial.print(temp.name);
-					Serial.print(F(" (long): "));
-					Serial.println(*((long*)temp.ptr));
+					printName(temp);
+					_out.print(F(" (long): "));
+					_out.println(*((long*)temp.ptr));
 					break;
 					
 				case Type::FLOAT:
-					Serial.print(temp.name);
-					Serial.println(F(" (float): Set usingFloats to true in initalize()"));
+					printName(temp);
+					_out.print(F(" (float): "));
+					printReal(*((float*)temp.ptr));
+					_out.println();
 					break;
 					
 				case Type::CHAR:
-					Serial.print(temp.name);
-					Serial.print(F(" (char): "));
-					Serial.println(*((char*)temp.ptr));
+					printName(temp);
+					_out.print(F(" (char): "));
+					_out.println(*((char*)temp.ptr));
 					break;
 						
 				case Type::BOOL:
-					Serial.print(temp.name);
+					printName(temp);
 					if(*(bool*)(temp.ptr))
 					{
-					Serial.print(F(" (bool): true"));
+						_out.println(F(" (bool): true"));
 					}
 					else
 					{
-						Serial.print(F(" (false): true"));
+						_out.println(F(" (bool): false"));
 					}
 					break;
 					
@@ -419,13 +929,15 @@ void ArduinoDebugger::displayVariables()
 				case Type::BYTE_ARRAY:
 				case Type::INT_ARRAY:
 				case Type::LONG_ARRAY:
+				case Type::FLOAT_ARRAY:
 				case Type::CHAR_ARRAY:
 				case Type::BOOL_ARRAY:
-					displayArray(temp);
+					displayArray(temp, 0, DEBUG_ARRAY_PAGE);
 					break;
 		 }
 	}
 	drawStars();
+	_out.flush();
 }
 
 /**********************************************************
@@ -441,32 +953,35 @@ void ArduinoDebugger::displayVariables()
 ***********************************************************/
 void ArduinoDebugger::updateVariables()
 {
-	displayVariables();
-	Serial.println(F("Enter the index of the variable to be updated.")); 
-	byte index = getSelection();
+	displayVariableView();
+	_out.println(F("Enter the index of the variable to be updated (R to refresh all variables).")); 
+	byte index = getSelection("R");
 	while(index != 255)
 	{
-		if(index < top_var_watch && index != 254)
+		if(index == 253)
+		{//Show every variable
+			clearScreen();
+			displayVariables();
+			index = getSelection("R");
+			continue;
+		}
+		if(index != 254 && watching(index))
 		{//Verify valid index was chosen
-			Variable temp = var_watch[index];
+			Variable temp = _watches[index];
 			bool valid = true;
 			long retrieved_val = 0;
-			if(temp.type == Type::BYTE_ARRAY || 
-				 temp.type == Type::INT_ARRAY ||
-				 temp.type == Type::LONG_ARRAY ||
-				 temp.type == Type::CHAR_ARRAY ||
-				 temp.type == Type::BOOL_ARRAY)
+			if(isArray(temp.type))
 			{
 				updateArray(temp);
 			}
 			else
 			{
-				Serial.print(F("New value for "));
-				Serial.print(temp.name);
+				_out.print(F("New value for "));
+				printName(temp);
 				switch(temp.type)
 				{					
 					case Type::BYTE:
-						Serial.print("(byte): ");
+						_out.print("(byte): ");
 						retrieved_val = getNumber(valid, Type::BYTE);
 						if(valid)
 						{
@@ -476,7 +991,7 @@ void ArduinoDebugger::updateVariables()
 						break;
 					
 					case Type::INT:
-						Serial.print("(int): ");
+						_out.print("(int): ");
 						retrieved_val = getNumber(valid, Type::INT);
 						if(valid)
 						{
@@ -486,7 +1001,7 @@ void ArduinoDebugger::updateVariables()
 						break;
 						
 					case Type::LONG:
-						Serial.print("(long): ");
+						_out.print("(long): ");
 						retrieved_val = getNumber(valid, Type::LONG);
 						if(valid)
 						{
@@ -495,9 +1010,16 @@ void ArduinoDebugger::updateVariables()
 						}
 						break;
 					
-					case Type::Float:
-						Serial.println(F(" (float): Set usingFloats to true in initalize()"));
+					case Type::FLOAT:
+					{
+						_out.print("(float): ");
+						float temp_float = getFloat(valid);
+						if(valid)
+						{
+							*(float*)(temp.ptr) = temp_float;
+						}
 						break;
+					}
 						
 					case Type::CHAR:
 						*(char*)(temp.ptr) = getChar();
@@ -515,388 +1037,2441 @@ void ArduinoDebugger::updateVariables()
 		}
 		else
 		{
-			Serial.println(F("Invalid Selection"));
+			_out.println(F("Invalid Selection"));
 		}
+		displayVariableView();
+		index = getSelection("R");
+	}
+}
+
+void ArduinoDebugger::displayVariableView()
+{
+	if(_snapshot.active())
+	{
+		displayChanges();
+	}
+	else
+	{
 		displayVariables();
-		index = getSelection();
 	}
 }
 
-void ArduinoDebugger::printName(char name[])
+void ArduinoDebugger::snapshotEnd()
 {
-	//Expected format for array variable name:
-	//     varName_SIZE
-	// Ex: pins_20
-	char trim_name[16];
-	char* ptr = strchr(name, '_');
-	int size = ptr - name;
-	strncpy(trim_name, name, size);
-	trim_name[size] = 0;
-	Serial.print(trim_name);
+	_snapshot.end();
+}
+
+/**********************************************************
+* @brief Display the watched values that changed since they were last shown.
+*
+*  Each variable, and each DEBUG_SNAPSHOT_BLOCK elements of an array,
+*  is compared against a checksum taken when it was last shown, so
+*  only the changed parts of large arrays are printed.  Everything is
+*  shown the first time and after a watch is added or removed.
+***********************************************************/
+void ArduinoDebugger::displayChanges()
+{
+	_out.println(F("\t\tChanged Variables"));
+	_out.println(F("[index] variable_name : value"));
+	drawStars();
+	ChangeRange range = {0, 0, 0, 0};
+	bool changes = false;
+	while(nextChange(range))
+	{
+		changes = true;
+		Variable var = _watches[range.index];
+		for(uint16_t i = range.start; i < range.start + range.count; i++)
+		{
+			_out.print(F("["));
+			_out.print(range.index);
+			_out.print(F("] "));
+			printName(var);
+			if(isArray(var.type))
+			{
+				_out.print(F("["));
+				_out.print(i);
+				_out.print(F("]"));
+			}
+			_out.print(F(": "));
+			printElement(var, i);
+			_out.println();
+		}
+	}
+	_snapshot.baseline();
+	if(!changes)
+	{
+		_out.println(F("No variables changed"));
+	}
+	drawStars();
+	_out.flush();
+}
+
+/**********************************************************
+* @brief Find the next run of changed elements.
+*
+*  Neighbouring blocks that changed are joined into one range.
+*
+*	@param range Start with every field 0, each call continues after
+*					the range it returned last
+*	@return false once every watch has been compared
+***********************************************************/
+bool ArduinoDebugger::nextChange(ChangeRange &range)
+{
+	uint16_t next = range.start + range.count;
+	for(; range.index < top_var_watch; range.index++, next = 0)
+	{
+		if(!watching(range.index))
+		{
+			continue;
+		}
+		Variable var = _watches[range.index];
+		byte size = getNumBytes(var.type);
+		bool found = false;
+		while(next < var.count)
+		{
+			uint16_t elements = var.count - next;
+			if(elements > DEBUG_SNAPSHOT_BLOCK)
+			{
+				elements = DEBUG_SNAPSHOT_BLOCK;
+			}
+			if(_snapshot.changed(range.block, (byte*)var.ptr + next * size, elements * size))
+			{
+				if(!found)
+				{
+					found = true;
+					range.start = next;
+				}
+			}
+			else if(found)
+			{//Compared again by the next call, it is still unchanged
+				break;
+			}
+			range.block++;
+			next += elements;
+		}
+		if(found)
+		{
+			range.count = next - range.start;
+			return true;
+		}
+	}
+	return false;
+}
+
+//Print one element of a watched variable (the value of a non array variable)
+void ArduinoDebugger::printElement(const Variable &var, uint16_t index)
+{
+	switch(var.type)
+	{
+		case Type::BYTE:
+		case Type::BYTE_ARRAY:
+			_out.print(((byte*)var.ptr)[index]);
+			break;
+			
+		case Type::INT:
+		case Type::INT_ARRAY:
+			_out.print(((int*)var.ptr)[index]);
+			break;
+			
+		case Type::LONG:
+		case Type::LONG_ARRAY:
+			_out.print(((long*)var.ptr)[index]);
+			break;
+			
+		case Type::FLOAT:
+		case Type::FLOAT_ARRAY:
+			printReal(((float*)var.ptr)[index]);
+			break;
+			
+		case Type::CHAR:
+		case Type::CHAR_ARRAY:
+			_out.print(((char*)var.ptr)[index]);
+			break;
+			
+		case Type::BOOL:
+		case Type::BOOL_ARRAY:
+			if(((bool*)var.ptr)[index])
+			{
+				_out.print(F("true"));
+			}
+			else
+			{
+				_out.print(F("false"));
+			}
+			break;
+	}
 }
 
-byte ArduinoDebugger::getSize(char name[])
+uint16_t ArduinoDebugger::getSize(char name[])
 {
 	//Expected format for array variable name:
 	//     varName_SIZE
 	// Ex: pins_20
-	char* end = strchr(name, '_');//The last underscore is the end of the variable name
-	byte size = 0;
+	char* end = strchr(name, '_');//The first underscore is the end of the variable name
+	uint16_t size = 0;
 	if(end != NULL)
 	{
-		size=atoi(end + 1);//Shorten to the actual variable name
+		size = strtoul(end + 1, NULL, 10);
 	}
 	return size;
 }
 
-void ArduinoDebugger::displayArray(Variable var)
+/**********************************************************
+* @brief Display part of an array.
+*
+*	@param var The array to display
+*	@param start The first element shown
+*	@param count The most elements shown, the rest are left for
+*					later pages
+***********************************************************/
+void ArduinoDebugger::displayArray(Variable var, uint16_t start, uint16_t count)
 {
-	printName(var.name);
+	printName(var);
 	switch(var.type)
 		{
 			case Type::BYTE_ARRAY:
-				Serial.println(F(" byte[]:"));
+				_out.println(F(" byte[]:"));
 				break;
 				
 			case Type::INT_ARRAY:
-				Serial.println(F(" int[]:"));
+				_out.println(F(" int[]:"));
 				break;
 				
 			case Type::LONG_ARRAY:
-				Serial.println(F(" long[]:"));
-				break;
-				
-			case Type::CHAR_ARRAY:
-				Serial.println(F(" char[]:"));
-				break;
-				
-			case Type::BOOL_ARRAY:
-			  Serial.println(F(" bool[]:"));
-				break;
-		}
-	byte size = getSize(var.name);
-	for(byte i = 0; i < size; i++ )
-	{
-		Serial.print(F("\t"));
-		printName(var.name);
-		Serial.print(F("["));
-		Serial.print(i);
-		Serial.print(F("]: "));
-		switch(var.type)
-		{
-			case Type::BYTE_ARRAY:
-				Serial.println(((byte*)var.ptr)[i]);
-				break;
-				
-			case Type::INT_ARRAY:
-				Serial.println(((int*)var.ptr)[i]);
+				_out.println(F(" long[]:"));
 				break;
 				
-			case Type::LONG_ARRAY:
-				Serial.println(((long*)var.ptr)[i]);
+			case Type::FLOAT_ARRAY:
+				_out.println(F(" float[]:"));
 				break;
 				
 			case Type::CHAR_ARRAY:
-				Serial.println(((char*)var.ptr)[i]);
+				_out.println(F(" char[]:"));
 				break;
 				
 			case Type::BOOL_ARRAY:
-			  if(((bool*)var.ptr)[i])
-				{
-					Serial.println(F("true"));
-				}
-				else
-				{
-					Serial.println(F("false"));
-				}
+			  _out.println(F(" bool[]:"));
 				break;
 		}
+	uint16_t end = windowEnd(var, start, count);
+	for(uint16_t i = start; i < end; i++)
+	{
+		_out.print(F("\t"));
+		printName(var);
+		_out.print(F("["));
+		_out.print(i);
+		_out.print(F("]: "));
+		printElement(var, i);
+		_out.println();
 	}
+	printWindow(var, start, end);
 }
 
-void ArduinoDebugger::updateArray(Variable var)
+//One past the last element of a window, clipped to the array
+uint16_t ArduinoDebugger::windowEnd(const Variable &var, uint16_t start, uint16_t count)
 {
-	clearScreen();
-	displayArray(var);
-	Serial.println(F("Enter array index to be updated."));
-	byte index = getSelection();
-	while(index != 255 )
+	if(start > var.count)
 	{
-		byte size = getSize(var.name);
-		if(index < size && index != 254)
-		{
-			bool valid = true;
-			long retrieved_val = 0;
-			Serial.print(F("New value for ["));
-			Serial.print(index);
-			Serial.println(F("]: "));
-			switch(var.type)
-			{
-				case Type::BYTE_ARRAY:
-					retrieved_val = getNumber(valid, Type::BYTE);
-					if(valid)
-					{
-						((byte*)var.ptr)[index] = (byte)retrieved_val;
-					}
-					break;
-					
-				case Type::INT_ARRAY:
-					retrieved_val = getNumber(valid, Type::INT);
-					if(valid)
-					{
-						((int*)var.ptr)[index] = (int)retrieved_val;
-					}
-					break;
-					
-				case Type::LONG_ARRAY:
-					retrieved_val = getNumber(valid, Type::LONG);
-					if(valid)
-					{
-						((long*)var.ptr)[index] = (long)retrieved_val;
-					}
-					break;
-					
-				case Type::CHAR_ARRAY:
-						((char*)var.ptr)[index]  = getChar();
-						break;
-					
-				case Type::BOOL_ARRAY: 
-					bool temp_bool = getBool(valid);
-					if(valid)
-					{
-						((bool*)var.ptr)[index] = temp_bool;
-					}
-					break;
-			}
-		}
-		else
-		{
-			Serial.println(F("Invalid Selection"));
-		}
-		clearScreen();
-		displayArray(var);
-		Serial.println(F("Enter array index to be updated."));
-	  index = getSelection();
+		return var.count;
 	}
-	
+	return (var.count - start > count) ? start + count : var.count;
 }
 
-
-byte ArduinoDebugger::getSelection()
+//Tell the user which elements are shown when it isn't the whole array
+void ArduinoDebugger::printWindow(const Variable &var, uint16_t start, uint16_t end)
 {
-	byte selection = 0;
-	Serial.print(F("Selection (Q to quit): "));
-	while(Serial.available() == 0){}
-	selection = Serial.peek();
-	if(selection == 'Q' || selection == 'q')
-	{
-		selection = 255;//Exit menu
-	}
-	else
+	if(start > 0 || end < var.count)
 	{
-		bool valid = true;
-		selection = getNumber(valid, BYTE);
-		if(!valid)
-		{
-			selection = 254;//Error occurred
-			Serial.println(F("Invalid Selection"));
-		}
+		_out.print(F("\tShowing ["));
+		_out.print(start);
+		_out.print(F("] to ["));
+		_out.print(end - 1);
+		_out.print(F("] of "));
+		_out.println(var.count);
 	}
-	clearBuffer();
-	return selection;
 }
 
 /**********************************************************
-* @brief Retrieve a number from the user and ensure it is both valid
-*        and fits within a set number of bytes.
-*
-*  This method will read an ASCII number from the Serial port using Arduino'saves
-*  Serial Library.  This method checks for valid values on 8-Bit & 32-Bit microcontrollers
-*	 8-Bit: Int (2 Bytes), Long (4 Bytes)
-*	 32-Bit: Int (4 Bytes), Long (8 Bytes)
+* @brief Display the smallest, largest & mean values of an array
+*				 and its first few elements, instead of every element.
 *
+*	@note The mean of a non float array is rounded towards zero.
+*	@param var The array to summarize
+***********************************************************/
+void ArduinoDebugger::displaySummary(Variable var)
+{
+	printName(var);
+	_out.print(F(" ("));
+	_out.print(var.count);
+	_out.println(F(" elements)"));
+	if(var.count == 0)
+	{
+		return;
+	}
+	if(var.type == Type::FLOAT_ARRAY && _real == NULL)
+	{
+		_out.print(F("\t"));
+		printReal(0);//Says floats need ArduinoDebuggerF
+	}
+	else if(var.type == Type::FLOAT_ARRAY)
+	{
+		float low, high, mean;
+		_real->summarize((float*)var.ptr, var.count, low, high, mean);
+		_out.print(F("\tmin: "));
+		printReal(low);
+		_out.print(F(", max: "));
+		printReal(high);
+		_out.print(F(", mean: "));
+		printReal(mean);
+	}
+	else
+	{//The mean is kept as a quotient & remainder so the sum can't overflow
+		long low = readInteger(var, 0);
+		long high = low;
+		long mean = 0;
+		long remainder = 0;
+		for(uint16_t i = 0; i < var.count; i++)
+		{
+			long value = readInteger(var, i);
+			low = (value < low) ? value : low;
+			high = (value > high) ? value : high;
+			mean += value / var.count;
+			remainder += value % var.count;
+			if(remainder >= (long)var.count)
+			{
+				mean++;
+				remainder -= var.count;
+			}
+			else if(remainder <= -(long)var.count)
+			{
+				mean--;
+				remainder += var.count;
+			}
+		}
+		//The mean is mean + remainder / count, which has the sign of the larger part
+		if(mean > 0 && remainder < 0)
+		{
+			mean--;
+		}
+		else if(mean < 0 && remainder > 0)
+		{
+			mean++;
+		}
+		_out.print(F("\tmin: "));
+		_out.print(low);
+		_out.print(F(", max: "));
+		_out.print(high);
+		_out.print(F(", mean: "));
+		_out.print(mean);
+	}
+	_out.println();
+	_out.print(F("\tfirst: "));
+	uint16_t end = windowEnd(var, 0, DEBUG_SUMMARY_FIRST);
+	for(uint16_t i = 0; i < end; i++)
+	{
+		if(i > 0)
+		{
+			_out.print(F(", "));
+		}
+		printElement(var, i);
+	}
+	_out.println();
+}
+
+/**********************************************************
+* @brief Public views of a watched array, by watch id.
+***********************************************************/
+void ArduinoDebugger::displayElements(byte id, uint16_t start, uint16_t count)
+{
+	if(watching(id) && isArray(_watches[id].type))
+	{
+		displayArray(_watches[id], start, count);
+		_out.flush();
+	}
+}
+
+void ArduinoDebugger::displaySummary(byte id)
+{
+	if(watching(id) && isArray(_watches[id].type))
+	{
+		displaySummary(_watches[id]);
+		_out.flush();
+	}
+}
+
+void ArduinoDebugger::displayArrayView(Variable var, uint16_t start, bool summary)
+{
+	if(summary)
+	{
+		displaySummary(var);
+	}
+	else
+	{
+		displayArray(var, start, DEBUG_ARRAY_PAGE);
+	}
+}
+
+/**********************************************************
+* @brief Run a letter command entered in an array's menu.
+*
+*  B updates several elements, N & P move to the next & previous
+*  page and S switches between the summary and the page.
+*
+*	@param var The array being viewed
+*	@param start The first element of the page, moved by N & P
+*	@param summary Whether the summary is shown, switched by S
+***********************************************************/
+void ArduinoDebugger::arrayCommand(Variable var, uint16_t &start, bool &summary)
+{
+	switch(_command)
+	{
+		case 'B':
+			updateArrayBulk(var);
+			break;
+			
+		case 'N':
+			if(var.count - start > DEBUG_ARRAY_PAGE)
+			{
+				start += DEBUG_ARRAY_PAGE;
+			}
+			summary = false;
+			break;
+			
+		case 'P':
+			start = (start > DEBUG_ARRAY_PAGE) ? start - DEBUG_ARRAY_PAGE : 0;
+			summary = false;
+			break;
+			
+		case 'S':
+			summary = !summary;
+			break;
+	}
+}
+
+void ArduinoDebugger::updateArray(Variable var)
+{
+	uint16_t start = 0;
+	bool summary = false;
+	clearScreen();
+	displayArrayView(var, start, summary);
+	_out.println(F("Enter array index to be updated (B to update several, N/P for the next/previous page, S for a summary)."));
+	uint16_t index = getIndex(DEBUG_ARRAY_COMMANDS);
+	while(index != 0xFFFF)
+	{
+		if(index == 0xFFFD)
+		{
+			arrayCommand(var, start, summary);
+		}
+		else if(index < var.count)
+		{
+			bool valid = true;
+			long retrieved_val = 0;
+			_out.print(F("New value for ["));
+			_out.print(index);
+			_out.println(F("]: "));
+			switch(var.type)
+			{
+				case Type::BYTE_ARRAY:
+					retrieved_val = getNumber(valid, Type::BYTE);
+					if(valid)
+					{
+						((byte*)var.ptr)[index] = (byte)retrieved_val;
+					}
+					break;
+					
+				case Type::INT_ARRAY:
+					retrieved_val = getNumber(valid, Type::INT);
+					if(valid)
+					{
+						((int*)var.ptr)[index] = (int)retrieved_val;
+					}
+					break;
+					
+				case Type::LONG_ARRAY:
+					retrieved_val = getNumber(valid, Type::LONG);
+					if(valid)
+					{
+						((long*)var.ptr)[index] = (long)retrieved_val;
+					}
+					break;
+					
+				case Type::FLOAT_ARRAY:
+				{
+					float temp_float = getFloat(valid);
+					if(valid)
+					{
+						((float*)var.ptr)[index] = temp_float;
+					}
+					break;
+				}
+					
+				case Type::CHAR_ARRAY:
+						((char*)var.ptr)[index]  = getChar();
+						break;
+					
+				case Type::BOOL_ARRAY: 
+					bool temp_bool = getBool(valid);
+					if(valid)
+					{
+						((bool*)var.ptr)[index] = temp_bool;
+					}
+					break;
+			}
+			start = index - index % DEBUG_ARRAY_PAGE;//Show the page holding the element
+		}
+		else
+		{
+			_out.println(F("Invalid Selection"));
+		}
+		clearScreen();
+		displayArrayView(var, start, summary);
+		_out.println(F("Enter array index to be updated (B to update several, N/P for the next/previous page, S for a summary)."));
+	  index = getIndex(DEBUG_ARRAY_COMMANDS);
+	}
+	
+}
+
+/**********************************************************
+* @brief Update a run of array elements from one line of input.
+*
+*  The user enters the first index, then the new values separated
+*  by commas (Ex: 10,20,30).  Each value is checked against the
+*  element type like getNumber() does and nothing is written unless
+*  every value is valid.
+*
+*	@note At most DEBUG_BULK_BYTES bytes are written at once.
+*	@param var The array being updated
+***********************************************************/
+void ArduinoDebugger::updateArrayBulk(Variable var)
+{
+	_out.print(F("First index: "));
+	bool valid = true;
+	long start = getNumber(valid, Type::LONG);
+	if(!valid || start < 0 || start >= var.count)
+	{
+		_out.println(F("Invalid Selection"));
+		return;
+	}
+	_out.println(F("Values separated by commas: "));
+	byte size = getNumBytes(var.type);
+	uint16_t room = var.count - start;
+	if(room > DEBUG_BULK_BYTES / size)
+	{
+		room = DEBUG_BULK_BYTES / size;
+	}
+	byte staged[DEBUG_BULK_BYTES];
+	uint16_t count = 0;
+	char text[16];
+	do
+	{//Read every value, even after an error, so none is left for the next prompt
+		bool clipped = readToken(text, sizeof(text), ',') == sizeof(text);
+		if(!_usingTerminal)
+		{
+			_out.print(text);
+			if(_last_char == ',')
+			{
+				_out.print(',');
+			}
+			else
+			{
+				_out.println();
+			}
+		}
+		if(!valid)
+		{
+			continue;
+		}
+		if(count == room)
+		{
+			_out.println(F("Too many values"));
+			valid = false;
+		}
+		else if(clipped || !parseElement(var.type, text, staged + count * size))
+		{
+			_out.print(F("Invalid value for ["));
+			_out.print(start + count);
+			_out.println(F("]"));
+			valid = false;
+		}
+		else
+		{
+			count++;
+		}
+	}while(_last_char == ',');
+	if(valid)
+	{
+		memcpy((byte*)var.ptr + start * size, staged, count * size);
+		_out.print(count);
+		_out.println(F(" values updated"));
+	}
+	else
+	{
+		_out.println(F("Nothing updated"));
+	}
+}
+
+/**********************************************************
+* @brief Convert text to one element of an array.
+*
+*	@param type The array's type
+*	@param text The value (Ex: 42, x or true)
+*	@param element Set to the element's bytes when the text is valid
+*	@return false if the text isn't a valid value for the element type
+***********************************************************/
+bool ArduinoDebugger::parseElement(Type type, char text[], byte element[])
+{
+	bool valid = true;
+	switch(type)
+	{
+		case Type::BYTE_ARRAY:
+		{
+			byte value = parseNumber(text, valid, Type::BYTE);
+			memcpy(element, &value, sizeof(value));
+			break;
+		}
+			
+		case Type::INT_ARRAY:
+		{
+			int value = parseNumber(text, valid, Type::INT);
+			memcpy(element, &value, sizeof(value));
+			break;
+		}
+			
+		case Type::LONG_ARRAY:
+		{
+			long value = parseNumber(text, valid, Type::LONG);
+			memcpy(element, &value, sizeof(value));
+			break;
+		}
+			
+		case Type::FLOAT_ARRAY:
+		{
+			float value = 0;
+			char* end = text;
+			valid = parseReal(end, value) && *end == 0;
+			memcpy(element, &value, sizeof(value));
+			break;
+		}
+			
+		case Type::CHAR_ARRAY:
+			valid = text[0] != 0 && text[1] == 0;
+			element[0] = text[0];
+			break;
+			
+		case Type::BOOL_ARRAY:
+			valid = text[0] == 'T' || text[0] == 't' || text[0] == 'F' || text[0] == 'f';
+			element[0] = (text[0] == 'T' || text[0] == 't');
+			break;
+			
+		default:
+			valid = false;
+	}
+	return valid;
+}
+
+
+byte ArduinoDebugger::getNumBytes(Type type)
+{
+	switch(type)
+	{
+		case Type::INT:
+		case Type::INT_ARRAY:
+			return sizeof(int);
+			
+		case Type::LONG:
+		case Type::LONG_ARRAY:
+			return sizeof(long);
+			
+		case Type::FLOAT:
+		case Type::FLOAT_ARRAY:
+			return sizeof(float);
+			
+		default://byte, char & bool
+			return 1;
+	}
+}
+
+bool ArduinoDebugger::isArray(Type type)
+{
+	//Every array type directly follows its element type in the Type enum
+	return (type % 2) == 1;
+}
+
+
+byte ArduinoDebugger::getSelection(const char commands[])
+{
+	uint16_t selection = getIndex(commands);
+	if(selection == 0xFFFF)
+	{
+		return 255;//Exit menu
+	}
+	else if(selection == 0xFFFD)
+	{
+		return 253;//Command letter entered
+	}
+	else if(selection > 252)
+	{
+		if(selection != 0xFFFE)
+		{
+			_out.println(F("Invalid Selection"));
+		}
+		return 254;//Error occurred
+	}
+	return selection;
+}
+
+/**********************************************************
+* @brief Retrieve a menu selection or array index from the user.
+*
+*	@param commands Optional (upper case) letters the menu accepts besides numbers & Q
+*	@return The number entered, 0xFFFF if the user quit (Q), 0xFFFD if
+*					a command letter was entered (kept in _command) or 0xFFFE
+*					if an invalid number was entered.
+***********************************************************/
+uint16_t ArduinoDebugger::getIndex(const char commands[])
+{
+	uint16_t index = 0;
+	_out.print(F("Selection (Q to quit): "));
+	char input[12];
+	bool clipped = readLine(input, sizeof(input)) == sizeof(input);
+	byte first = input[0];
+	if(clipped)
+	{//Only part of the number was kept
+		index = 0xFFFE;
+		_out.println(F("Input too long"));
+	}
+	else if(first == 'Q' || first == 'q')
+	{
+		index = 0xFFFF;//Exit menu
+	}
+	else if(commands != NULL && first != 0 && strchr(commands, toupper(first)) != NULL)
+	{
+		index = 0xFFFD;//Menu specific command
+		_command = toupper(first);
+	}
+	else
+	{
+		bool valid = true;
+		long value = parseNumber(input, valid, LONG);
+		if(!valid || value < 0 || value >= 0xFFFD)
+		{
+			index = 0xFFFE;//Error occurred
+			_out.println(F("Invalid Selection"));
+		}
+		else
+		{
+			index = value;
+		}
+	}
+	return index;
+}
+
+/**********************************************************
+* @brief Retrieve a number from the user and ensure it is both valid
+*        and fits within a set number of bytes.
+*
+*  This method will read an ASCII number from the Serial port using Arduino'saves
+*  Serial Library.  This method checks for valid values on 8-Bit & 32-Bit microcontrollers
+*	 8-Bit: Int (2 Bytes), Long (4 Bytes)
+*	 32-Bit: Int (4 Bytes), Long (8 Bytes)
+*
+*
+*  @note If the converted number causes overflow or does not fit within
+*  the set number of bytes (parameter), this method will set the parameter
+*  valid to false.
+*  
+*	 @param valid - a boolean (passed by reference)
+*	 @param type - The type of number being used
+***********************************************************/
+long ArduinoDebugger::getNumber(bool &valid, Type type)
+{
+  char input[12];
+  if(readLine(input, sizeof(input)) == sizeof(input))
+  {//Only part of the number was kept
+    _out.println(F("Input too long"));
+    valid = false;
+    return 0;
+  }
+  return parseNumber(input, valid, type);
+}
+
+/**********************************************************
+* @brief Convert text to a number and ensure it fits within a type.
+*
+*	 @param input - The text to convert
+*	 @param valid - set to false if the text isn't a number that fits
+*	 @param type - The type of number being used
+***********************************************************/
+long ArduinoDebugger::parseNumber(char input[], bool &valid, Type type)
+{
+	valid = true;//Assume value is valid
+	bool outRange = false;//Determine if the number is too large/small
+	char* eptr;//Points to the first character that COULD NOT be converted, may be null if all values could be converted
+  errno = 0;
+  long result = strtol(input, &eptr, 10);//Convert user input to long
+  if(eptr == input || !(*eptr == 0 || *eptr == 13 || *eptr == 10))
+  {//Check if a non-numeric character was entered
+    _out.println(F("Not a number"));
+		valid = false;
+  }
+  else if(errno == ERANGE)
+  {//Check if the value was too large for a long
+
+    outRange = true;
+	}
+	else if(type != LONG){
+		long check = 0;
+		switch(type)
+		{//Verify the user input fits in the destination size
+			case Type::BYTE:
+				check = (byte)result; 
+				break;
+				
+			case Type::INT:
+				check = (int)result;
+				break;
+				
+		}
+		if(check != result)
+		{
+			outRange = true;
+		}
+	}
+	if(outRange)
+	{
+		_out.println(F("Value Out of Range"));
+		valid = false;
+	}
+	return result;
+}
+
+/**********************************************************
+* @brief Retrieve a float from the user and ensure it is valid.
+*
+*  @note valid is set to false (and an error displayed) unless the whole
+*  line is a number that fits in a float.
+*
+*	 @param valid - a boolean (passed by reference)
+***********************************************************/
+float ArduinoDebugger::getFloat(bool &valid)
+{
+	if(_real == NULL)
+	{//Nothing to read the value with
+		valid = false;
+		_out.println(F(" (float): Set usingFloats to true in initalize()"));
+		return 0;
+	}
+	char input[16];
+	if(readLine(input, sizeof(input)) == sizeof(input))
+	{//Only part of the number was kept
+		_out.println(F("Input too long"));
+		valid = false;
+		return 0;
+	}
+	char* end = input;
+	float result = 0;
+	valid = parseReal(end, result);
+	if(valid && *end != 0)
+	{//Text after the number (Ex: 1.5.2)
+		valid = false;
+	}
+	if(!valid)
+	{//parseReal() only moves past a number that is out of range
+		_out.println(end == input || *end != 0 ? F("Not a number") : F("Value Out of Range"));
+	}
+	return result;
+}
+
+char ArduinoDebugger::getChar()
+{
+	_out.print(F("(char): "));
+	char input[4];
+	readLine(input, sizeof(input));
+	clearScreen();
+	return input[0];
+}
+
+
+bool ArduinoDebugger::getBool(bool &valid)
+{
+	bool value = true;
+	valid = true;
+	_out.print("(bool): ");
+	char input[8];
+	readLine(input, sizeof(input));
+	byte bool_char = input[0];
+	
+	if(bool_char == 'F' || bool_char == 'f')
+	{
+		value = false;
+	}
+	else if(bool_char != 'T' && bool_char != 't')
+	{
+		valid = false;
+		_out.println(F("Value must be (t)rue or (f)alse"));
+	}
+	return value;
+}
+/**************************************************************************
+* 
+*  @brief Pause the currently running Arduino program
+*	
+*	This method will pause the arduino program and wait until the user
+*			enters a value via the Serial port to continue
+*	@note This method requires the Serial port to have a connection in order to
+*			work correctly.
+***/    
+void ArduinoDebugger::pause()
+{
+	if(_port != &Serial || Serial)
+	{//Verify the Serial port is accessible (other ports can't tell)
+		_out.println(F("Press ENTER to continue"));
+		char input[4];
+		readLine(input, sizeof(input)); //Wait until input is provided on the Serial port
+	}
+}
+
+
+/**************************************************************************
+* 
+*  @brief Clear the Serial Buffer
+*	
+*	This method will remove any characters already within the Serial Buffer
+*	without waiting for more to arrive.
+***/
+void ArduinoDebugger::clearBuffer()
+{
+	while(_port->available() > 0)
+	{//remove any remaining values from the Serial buffer
+		_port->read();
+	}
+}
+
+/**************************************************************************
+* 
+*  @brief Clear the screen on Serial Monitor
+*	
+*	This method will "clear" the screen by feeding a series of newlines to move the
+* location in the Serial Monitor to be further down.  
+***/
+void ArduinoDebugger::clearScreen()
+{
+	_screen_bytes = _out.count();
+	_out.resetCount();
+	if(_usingTerminal)
+	{
+		_out.write(27);
+		_out.print(F("[2J"));// clear screen command
+		_out.write(27);
+		_out.print(F("[H"));
+	}
+	else
+	{
+		for(int i = 0; i < 15; i++)
+		{
+			_out.println();
+		}
+	}
+}
+
+/***********************************************************
+* 
+*  Print a series of asterisks on the Serial monitor.
+*	
+***/
+void ArduinoDebugger::drawStars()
+{
+	_out.repeat('*', 50);
+	_out.println();
+}
+
+unsigned long ArduinoDebugger::lastScreenBytes()
+{
+	return _screen_bytes;
+}
+
+/**************************************************************************
+* 
+*  @brief Send any buffered output, then wait for the user to type something.
+***/
+void ArduinoDebugger::waitForInput()
+{
+	_out.flush();
+	while(_port->available() == 0){}
+}
+
+/**************************************************************************
+* 
+*  @brief Read one line typed by the user.
+*	
+*	The line ends as soon as CR, LF or the terminator set with setTerminator()
+*	arrives.  If the sender doesn't end its lines (Ex: Serial Monitor set to
+*	"No line ending"), the line ends once no byte has arrived for the input
+*	timeout (see setInputTimeout()).  Characters that don't fit are dropped.
+*	
+*	@param buffer Filled with the null terminated line (without its ending)
+*	@param size The size of buffer
+*	@return The number of characters stored, or size if the line didn't fit
+***/
+byte ArduinoDebugger::readLine(char buffer[], byte size)
+{
+	byte length = readToken(buffer, size, 0);
+	if(!_usingTerminal)
+	{
+		_out.println(buffer);//echo input to screen
+	}
+	return length;
+}
+
+/**************************************************************************
+* 
+*  @brief Read the next part of a line split by a delimiter (Ex: 1,2,3).
+*	
+*	Ends like readLine() or at the delimiter, without echoing.  The character
+*	that ended it is left in _last_char, so more parts follow while it is
+*	the delimiter.
+*	
+*	@param buffer Filled with the null terminated text
+*	@param size The size of buffer
+*	@param delimiter The character between parts, 0 for a whole line
+*	@return The number of characters stored, or size if the part didn't fit
+*					(the rest of it is read & dropped)
+***/
+byte ArduinoDebugger::readToken(char buffer[], byte size, char delimiter)
+{
+	byte length = 0;
+	waitForInput();
+	while(_last_char == '\r' && _port->peek() == '\n')
+	{//Second half of a CR LF line ending
+		_last_char = _port->read();
+		waitForInput();
+	}
+	unsigned long last_byte = millis();
+	bool clipped = false;
+	while(true)
+	{
+		if(_port->available() > 0)
+		{
+			char data = _port->read();
+			_last_char = data;
+			last_byte = millis();
+			if(data == '\r' || data == '\n' || data == _terminator || (delimiter != 0 && data == delimiter))
+			{
+				break;
+			}
+			if(length < size - 1)
+			{
+				buffer[length] = data;
+				length++;
+			}
+			else
+			{
+				clipped = true;
+			}
+		}
+		else if(millis() - last_byte >= _input_timeout)
+		{//Sender doesn't end its lines
+			break;
+		}
+	}
+	buffer[length] = 0;//Null terminate
+	return clipped ? size : length;
+}
+
+/**************************************************************************
+* 
+*  @brief Set an extra character (besides CR & LF) that ends a line of input.
+***/
+void ArduinoDebugger::setTerminator(char terminator)
+{
+	_terminator = terminator;
+}
+
+/**************************************************************************
+* 
+*  @brief Set how long to wait for the next character of a line that
+*	hasn't been terminated, in milliseconds.
+***/
+void ArduinoDebugger::setInputTimeout(unsigned int timeout)
+{
+	_input_timeout = timeout;
+}
+
+/**************************************************************************
+* 
+*  @brief Send & receive through another port instead of Serial.
+*	
+*	Any Stream works (Ex: Serial1, SoftwareSerial, USB), so the debugger
+*	can have a fast port of its own while the sketch keeps using Serial.
+*	The sketch opens the port (Ex: Serial1.begin(115200)).
+*	
+*	@param port The port used for the menus & the binary protocol
+***/
+void ArduinoDebugger::setPort(Stream &port)
+{
+	_out.flush();//Anything waiting goes to the old port
+	_port = &port;
+	_port_room = 0;
+	_out.setPort(port);
+}
+
+/**********************************************************
+* @brief Halt the program and let a host tool drive the debugger.
+*
+*  Replaces the text menus when usingProtocol is set.  A HALT frame
+*  carrying the breakpoint's label is sent, then command frames are
+*  answered until the host sends OP_CONTINUE.
+*
+*	@param name A string for labeling the breakpoint.
+***********************************************************/
+void ArduinoDebugger::protocolBreakpoint(char name[])
+{
+	_protocol.sendFrame(OP_HALT, name, strlen(name));
+	_out.flush();
+	bool halted = true;
+	while(halted)
+	{
+		if(_port->available() > 0)
+		{
+			FrameStatus status = _protocol.feed(_port->read());
+			if(status == FRAME_READY)
+			{
+				halted = handleFrame();
+				finishReply();
+			}
+			else if(status == FRAME_ERROR)
+			{
+				_protocol.sendNak(ERR_CHECKSUM);
+				_out.flush();
+			}
+		}
+	}
+}
+
+/**********************************************************
+* @brief Service the binary protocol without halting the program.
+*
+*  poll() is meant to be called on every pass through loop().  It only
+*  reads bytes that have already arrived (at most DEBUG_POLL_BYTES) and
+*  runs at most one command per call, so watched variables can be read
+*  and written while the program keeps running.  Answers are sent
+*  DEBUG_POLL_REPLY bytes per call, only while the port has room for
+*  them, and the next command isn't read until the answer is done.
+*
+*	@note poll() always speaks the binary protocol, even when the text
+*  menus are used by breakpoint().  OP_CONTINUE is acknowledged and
+*  otherwise ignored since the program is not halted.
+*	@note No frame is longer than DEBUG_POLL_REPLY, so a read of a large
+*  array is clipped to a smaller window (see OP_READ_VAR).
+***********************************************************/
+void ArduinoDebugger::poll()
+{
+	unsigned int budget = DEBUG_POLL_BYTES;
+	while(_reply == 0 && budget > 0 && _port->available() > 0)
+	{
+		budget--;
+		FrameStatus status = _protocol.feed(_port->read());
+		if(status == FRAME_READY)
+		{
+			handleFrame();
+			break;
+		}
+		else if(status == FRAME_ERROR)
+		{
+			_protocol.sendNak(ERR_CHECKSUM);
+			break;
+		}
+	}
+	const byte most = DEBUG_POLL_REPLY - 4 < 255 ? DEBUG_POLL_REPLY - 4 : 255;//Payload of the longest frame
+	unsigned long start = _out.count();
+	while(_reply != 0 && _out.count() - start < DEBUG_POLL_REPLY && portHasRoom(_out.buffered() + most + 4))
+	{
+		replyFrame(most);
+	}
+	_out.flush();
+}
+
+/**********************************************************
+* @brief Check that length more bytes can be written without waiting.
+*
+*  The most room the port has reported is taken as an empty buffer, so a
+*  frame longer than the port's buffer still goes out once it has
+*  drained.  A port that doesn't report its room (0) is always written.
+***********************************************************/
+bool ArduinoDebugger::portHasRoom(unsigned int length)
+{
+	int room = _port->availableForWrite();
+	if(room > _port_room)
+	{
+		_port_room = room;
+	}
+	return room >= (int)length || room == _port_room;
+}
+
+/**********************************************************
+* @brief Watch the port for the break-in sequence without halting.
+*
+*  Meant for serialEvent() or a timer interrupt.  The bytes waiting on
+*  the port (at most DEBUG_POLL_BYTES) are matched against the sequence
+*  set by setBreakSequence() (an OP_BREAK frame unless changed), and a
+*  match makes the next checkpoint() start a session labeled "Break-in".
+*
+*	@note The bytes read are discarded, so the port should be left to the
+*  debugger (see setPort()).  poll() answers OP_BREAK itself, so a sketch
+*  that calls poll() doesn't need this.
+***********************************************************/
+void ArduinoDebugger::serviceBreakIn()
+{
+	unsigned int budget = DEBUG_POLL_BYTES;
+	while(budget > 0 && _port->available() > 0)
+	{
+		budget--;
+		byte data = _port->read();
+		while(_break_matched > 0 && data != _break_sequence[_break_matched])
+		{//Fall back to the longest match that the byte may still extend (Ex: !!!x for !!x)
+			_break_matched = breakFallback(_break_matched);
+		}
+		if(data == _break_sequence[_break_matched])
+		{
+			_break_matched++;
+		}
+		if(_break_matched == _break_length)
+		{
+			_break_matched = 0;
+			_break_in = true;
+		}
+	}
+}
+
+//Longest start of the sequence that also ends its first matched bytes, so
+//serviceBreakIn() never has to read a byte twice
+byte ArduinoDebugger::breakFallback(byte matched)
+{
+	for(byte length = matched - 1; length > 0; length--)
+	{
+		if(memcmp(_break_sequence, _break_sequence + matched - length, length) == 0)
+		{
+			return length;
+		}
+	}
+	return 0;
+}
+
+/**************************************************************************
+* 
+*  @brief Set the bytes that ask the program to break in.
+*
+*  @param sequence The bytes to watch for
+*  @param length The number of bytes, at most DEBUG_BREAK_LENGTH
+*  @return false (keeping the old sequence) when length doesn't fit
+***/
+bool ArduinoDebugger::setBreakSequence(const byte sequence[], byte length)
+{
+	if(length == 0 || length > DEBUG_BREAK_LENGTH)
+	{
+		return false;
+	}
+	memcpy(_break_sequence, sequence, length);
+	_break_length = length;
+	_break_matched = 0;
+	return true;
+}
+
+bool ArduinoDebugger::setBreakSequence(const char sequence[])
+{
+	size_t length = strlen(sequence);
+	return length <= DEBUG_BREAK_LENGTH && setBreakSequence((const byte*)sequence, length);
+}
+
+//The session checkpoint() starts, it halts even while profiling
+void ArduinoDebugger::breakIn()
+{
+	static char label[] = "Break-in";
+	halt(label);
+}
+
+/**********************************************************
+* @brief Run the command held in the protocol's receive buffer.
+*
+*  Answers of several frames are only started (see startReply()).
+*
+*	@return false once the host asks the program to continue
+***********************************************************/
+bool ArduinoDebugger::handleFrame()
+{
+	byte* payload = _protocol.payload();
+	byte length = _protocol.length();
+	switch(_protocol.opcode())
+	{
+		case OP_LIST_WATCHES:
+		case OP_DUMP_TRACE:
+		case OP_READ_PROFILE:
+		case OP_READ_TABLE:
+		case OP_READ_VAR:
+		case OP_READ_VALUES:
+		case OP_READ_PINS:
+		case OP_READ_PIN_CHANGES:
+			startReply(_protocol.opcode());
+			break;
+			
+		case OP_READ_CHANGES:
+			if(_snapshot.active())
+			{
+				startReply(OP_READ_CHANGES);
+			}
+			else
+			{
+				_protocol.sendNak(ERR_VALUE);
+			}
+			break;
+			
+		case OP_WRITE_VAR:
+			writeValue(payload, length);
+			break;
+			
+		case OP_WRITE_PIN:
+			if(length != 2)
+			{
+				_protocol.sendNak(ERR_LENGTH);
+			}
+			else if(payload[0] >= NUM_DIGITAL_PINS || payload[1] > 1)
+			{
+				_protocol.sendNak(ERR_VALUE);
+			}
+			else
+			{
+				digitalWrite(payload[0], payload[1] ? HIGH : LOW);
+				_protocol.sendAck();
+			}
+			break;
+			
+		case OP_BREAK://Answered by the HALT frame at the next checkpoint()
+			_break_in = true;
+			_protocol.sendAck();
+			break;
+			
+		case OP_SET_CONDITION:
+			if(setCondition(payload, length))
+			{
+				_protocol.sendAck();
+			}
+			else
+			{
+				_protocol.sendNak(ERR_VALUE);
+			}
+			break;
+			
+		case OP_CONTINUE:
+			_protocol.sendAck();
+			return false;
+			
+		default:
+			_protocol.sendNak(ERR_OPCODE);
+	}
+	return true;
+}
+
+/**********************************************************
+* @brief Describe one watched variable to the host.
+*
+*  Payload: index, type, element size, element count (2 bytes), name
+***********************************************************/
+void ArduinoDebugger::sendWatch(byte index, byte most)
+{
+	Variable var = _watches[index];
+	byte name_length = nameLength(var);
+	if(name_length > most - 5)
+	{
+		name_length = most - 5;
+	}
+	uint16_t count = var.count;
+	_protocol.beginFrame(OP_WATCH, 5 + name_length);
+	_protocol.writeByte(index);
+	_protocol.writeByte(var.type);
+	_protocol.writeByte(getNumBytes(var.type));
+	_protocol.writeByte(count & 0xFF);
+	_protocol.writeByte(count >> 8);
+	for(byte i = 0; i < name_length; i++)
+	{
+		_protocol.writeByte(nameChar(var, i));
+	}
+	_protocol.endFrame();
+}
+
+/**********************************************************
+* @brief Start answering a command that reads from the program.
+*
+*  handleFrame() only starts these answers.  A halted program sends the
+*  whole answer at once (finishReply()), poll() sends it a piece per
+*  call (DEBUG_POLL_REPLY bytes) so a long answer doesn't hold up the
+*  program.  Answers of several frames end with an ACK.
+*
+*  OP_READ_VAR, OP_READ_VALUES, OP_READ_PINS & OP_READ_PIN_CHANGES: one
+*  frame, no ACK.  The request's payload is still held by _protocol,
+*  since no command is read until the answer is sent.
+*  OP_LIST_WATCHES: one WATCH frame per watch.
+*  OP_READ_TABLE: a TABLE frame (generation, watch count, capacity),
+*  then one WATCH frame per watch.  Afterwards the host reads values by
+*  id with OP_READ_VALUES and only fetches the table again when the
+*  generation it reports has changed.
+*  OP_DUMP_TRACE: a TRACE frame describing the layout (record size (2),
+*  record count (2), channel count, watch index of each channel), then
+*  TRACE_DATA frames carrying the raw records, oldest first.  No samples
+*  are recorded until the last one is sent.
+*  OP_READ_PROFILE: one PROFILE frame per breakpoint (see sendProbe()).
+*  OP_READ_CHANGES: one VALUE frame (index, start (2), raw element bytes)
+*  per run of changed elements, long runs are split across frames.
+*
+*	@param opcode The command being answered
+***********************************************************/
+void ArduinoDebugger::startReply(byte opcode)
+{
+	_reply = opcode;
+	_reply_generation = _generation;
+	_reply_position = 0;
+	ChangeRange start = {0, 0, 0, 0};
+	_reply_range = start;
+}
+
+/**********************************************************
+* @brief Send the next frame of the answer in progress, or the ACK
+*        that ends it.
+*
+*	@param most Largest payload, answers are clipped or split to fit
+***********************************************************/
+void ArduinoDebugger::replyFrame(byte most)
+{
+	switch(_reply)
+	{
+		case OP_READ_VAR:
+			_reply = 0;
+			sendValue(_protocol.payload(), _protocol.length(), most);
+			return;
+			
+		case OP_READ_VALUES:
+			_reply = 0;
+			sendValues(_protocol.payload(), _protocol.length(), most);
+			return;
+			
+		case OP_READ_PINS:
+			_reply = 0;
+			sendPins();
+			return;
+			
+		case OP_READ_PIN_CHANGES:
+			_reply = 0;
+			sendPinChanges(_protocol.payload(), _protocol.length(), most);
+			return;
+			
+
+		case OP_READ_TABLE:
+			if(_reply_position == 0)
+			{
+				byte count = 0;
+				for(byte i = 0; i < top_var_watch; i++)
+				{
+					if(watching(i))
+					{
+						count++;
+					}
+				}
+				_protocol.beginFrame(OP_TABLE, 3);
+				_protocol.writeByte(_generation);
+				_protocol.writeByte(count);
+				_protocol.writeByte(_watch_capacity);
+				_protocol.endFrame();
+				_reply_position++;
+				return;
+			}
+			//Fall through - then the same WATCH frames as OP_LIST_WATCHES
+		case OP_LIST_WATCHES:
+			//_reply_position is one past the next watch to look at
+			if(_reply_position == 0)
+			{
+				_reply_position = 1;
+			}
+			for(; _reply_position <= top_var_watch; _reply_position++)
+			{
+				if(watching(_reply_position - 1))
+				{
+					sendWatch(_reply_position - 1, most);
+					_reply_position++;
+					return;
+				}
+			}
+			break;
+			
+		case OP_DUMP_TRACE:
+			if(_reply_position == 0)
+			{
+				byte channels = _trace.channels();
+				unsigned int record_size = _trace.recordSize();
+				unsigned int count = _trace.count();
+				_protocol.beginFrame(OP_TRACE, 5 + channels);
+				_protocol.writeByte(record_size & 0xFF);
+				_protocol.writeByte(record_size >> 8);
+				_protocol.writeByte(count & 0xFF);
+				_protocol.writeByte(count >> 8);
+				_protocol.writeByte(channels);
+				for(byte i = 0; i < channels; i++)
+				{
+					_protocol.writeByte(_trace.channelIndex(i));
+				}
+				_protocol.endFrame();
+				_reply_position++;
+				return;
+			}
+			//_reply_position is one past the offset of the next byte
+			if(_reply_position - 1 < (unsigned long)_trace.count() * _trace.recordSize())
+			{
+				unsigned int length;
+				const byte* data = _trace.data(_reply_position - 1, length);
+				if(length > most)
+				{
+					length = most;
+				}
+				_protocol.sendFrame(OP_TRACE_DATA, data, length);
+				_reply_position += length;
+				return;
+			}
+			break;
+			
+		case OP_READ_PROFILE:
+			if(_reply_position < _profile.count())
+			{
+				sendProbe(_reply_position, most);
+				_reply_position++;
+				return;
+			}
+			break;
+			
+		case OP_READ_CHANGES:
+			if(_generation != _reply_generation)
+			{//A watch was added or removed part way, the next request sends every value
+				break;
+			}
+			//_reply_position is the elements of _reply_range already sent
+			if(_reply_position == _reply_range.count)
+			{
+				_reply_position = 0;
+				if(!nextChange(_reply_range))
+				{//Every checksum was stored while comparing
+					_snapshot.baseline();
+					break;
+				}
+			}
+			{
+				Variable var = _watches[_reply_range.index];
+				byte size = getNumBytes(var.type);
+				uint16_t start = _reply_range.start + _reply_position;
+				uint16_t count = _reply_range.count - _reply_position;
+				if(count > (most - 3) / size)
+				{//Keep each frame inside the largest payload
+					count = (most - 3) / size;
+				}
+				_protocol.beginFrame(OP_VALUE, 3 + count * size);
+				_protocol.writeByte(_reply_range.index);
+				_protocol.writeByte(start & 0xFF);
+				_protocol.writeByte(start >> 8);
+				_protocol.writeBytes((byte*)var.ptr + start * size, count * size);
+				_protocol.endFrame();
+				_reply_position += count;
+			}
+			return;
+	}
+	_reply = 0;
+	_protocol.sendAck();
+}
+
+//Send the rest of the answer in progress
+void ArduinoDebugger::finishReply()
+{
+	while(_reply != 0)
+	{
+		replyFrame(255);
+	}
+	_out.flush();//The host is waiting on the whole answer
+}
+
+/**********************************************************
+* @brief Send the values of several watches in one frame.
+*
+*  Request payload: id of each watch
+*  Response payload: generation, then the raw bytes of each watch in
+*  the order requested (sizes are known from the watch table)
+*
+*	@note Answered with a NAK (length) if the values don't fit in one frame
+*  of most bytes.
+***********************************************************/
+void ArduinoDebugger::sendValues(byte payload[], byte length, byte most)
+{
+	if(length == 0)
+	{
+		_protocol.sendNak(ERR_LENGTH);
+		return;
+	}
+	unsigned long total = 1;
+	for(byte i = 0; i < length; i++)
+	{
+		if(!watching(payload[i]))
+		{
+			_protocol.sendNak(ERR_INDEX);
+			return;
+		}
+		Variable var = _watches[payload[i]];
+		total += (unsigned long)getNumBytes(var.type) * var.count;
+		if(total > most)
+		{
+			_protocol.sendNak(ERR_LENGTH);
+			return;
+		}
+	}
+	_protocol.beginFrame(OP_VALUES, total);
+	_protocol.writeByte(_generation);
+	for(byte i = 0; i < length; i++)
+	{
+		Variable var = _watches[payload[i]];
+		_protocol.writeBytes((byte*)var.ptr, getNumBytes(var.type) * var.count);
+	}
+	_protocol.endFrame();
+}
+
+/**********************************************************
+* @brief Send the raw bytes of a watched variable.
+*
+*  Request payload: index [, start (2 bytes), count]
+*  Response payload: index, start (2 bytes), raw element bytes
+*
+*  @note Large arrays are clipped to a single frame of most bytes, the
+*  host reads the remainder by asking for a later start index.
+***********************************************************/
+void ArduinoDebugger::sendValue(byte payload[], byte length, byte most)
+{
+	if(length != 1 && length != 4)
+	{
+		_protocol.sendNak(ERR_LENGTH);
+		return;
+	}
+	if(!watching(payload[0]))
+	{
+		_protocol.sendNak(ERR_INDEX);
+		return;
+	}
+	Variable var = _watches[payload[0]];
+	byte size = getNumBytes(var.type);
+	uint16_t total = var.count;
+	uint16_t start = 0;
+	uint16_t count = total;
+	if(length == 4)
+	{
+		start = payload[1] | (payload[2] << 8);
+		count = payload[3];
+	}
+	if(start > total || count > total - start)
+	{
+		_protocol.sendNak(ERR_INDEX);
+		return;
+	}
+	if(count > (most - 3) / size)
+	{//Keep the response inside one frame
+		count = (most - 3) / size;
+	}
+	_protocol.beginFrame(OP_VALUE, 3 + count * size);
+	_protocol.writeByte(payload[0]);
+	_protocol.writeByte(start & 0xFF);
+	_protocol.writeByte(start >> 8);
+	_protocol.writeBytes((byte*)var.ptr + start * size, count * size);
+	_protocol.endFrame();
+}
+
+/**********************************************************
+* @brief Overwrite a watched variable with raw bytes from the host.
+*
+*  Request payload: index, start (2 bytes), raw element bytes
+*
+*  @note Nothing is written unless every element is valid.
+***********************************************************/
+void ArduinoDebugger::writeValue(byte payload[], byte length)
+{
+	if(length < 4)
+	{
+		_protocol.sendNak(ERR_LENGTH);
+		return;
+	}
+	if(!watching(payload[0]))
+	{
+		_protocol.sendNak(ERR_INDEX);
+		return;
+	}
+	Variable var = _watches[payload[0]];
+	byte size = getNumBytes(var.type);
+	uint16_t total = var.count;
+	uint16_t start = payload[1] | (payload[2] << 8);
+	byte data_length = length - 3;
+	if(data_length % size != 0)
+	{
+		_protocol.sendNak(ERR_LENGTH);
+		return;
+	}
+	if(start > total || data_length / size > total - start)
+	{
+		_protocol.sendNak(ERR_INDEX);
+		return;
+	}
+	if(var.type == Type::BOOL || var.type == Type::BOOL_ARRAY)
+	{//bool must be stored as 0 or 1
+		for(byte i = 3; i < length; i++)
+		{
+			if(payload[i] > 1)
+			{
+				_protocol.sendNak(ERR_VALUE);
+				return;
+			}
+		}
+	}
+	memcpy((byte*)var.ptr + start * size, payload + 3, data_length);
+	_protocol.sendAck();
+}
+
+/**********************************************************
+* @brief Send the state of every pin to the host.
+*
+*  Payload: digital pin count, output HIGH bitmap, input HIGH bitmap,
+*  analog pin count, analog values (2 bytes each)
+***********************************************************/
+void ArduinoDebugger::sendPins()
+{
+	byte bitmap_length = DEBUG_PIN_BYTES;
+	_protocol.beginFrame(OP_PINS, 2 + 2 * bitmap_length + 2 * NUM_ANALOG_INPUTS);
+	_protocol.writeByte(NUM_DIGITAL_PINS);
+	readPins(_pins);
+	_protocol.writeBytes(_pins.powered, bitmap_length);
+	_protocol.writeBytes(_pins.high, bitmap_length);
+	_protocol.writeByte(NUM_ANALOG_INPUTS);
+	for(int i = A0; i < NUM_ANALOG_INPUTS + A0; i++)
+	{
+		int value = analogRead(i);
+		_analog[i - A0] = value;
+		_protocol.writeByte(value & 0xFF);
+		_protocol.writeByte(value >> 8);
+	}
+	_protocol.endFrame();
+}
+
+/**********************************************************
+* @brief Send only the pins that changed since they were last sent.
+*
+*  Request payload: [dead-band (2 bytes)]
+*  Response payload: digital change count, (pin, state) per change,
+*  analog change count, (analog index, value (2 bytes)) per change.
+*  A digital state has bit 0 set when providing power and bit 1 set
+*  when reading HIGH.  Changes that don't fit in most bytes are left
+*  for the next request.
+***********************************************************/
+void ArduinoDebugger::sendPinChanges(byte payload[], byte length, byte most)
+{
+	if(length == 2)
+	{
+		_deadband = payload[0] | (payload[1] << 8);
+	}
+	PinSnapshot previous = _pins;
+	readPins(_pins);
+	int values[NUM_ANALOG_INPUTS];
+	byte room = most - 2;
+	byte digital_changes = 0;
+	byte analog_changes = 0;
+	for(int i = 0; i < NUM_DIGITAL_PINS; i++)
+	{
+		if(pinChanged(previous, i))
+		{
+			if(room >= 2)
+			{
+				digital_changes++;
+				room -= 2;
+			}
+			else
+			{//Still reported as changed next time
+				bitWrite(_pins.powered[i / 8], i % 8, bitRead(previous.powered[i / 8], i % 8));
+				bitWrite(_pins.high[i / 8], i % 8, bitRead(previous.high[i / 8], i % 8));
+			}
+		}
+	}
+	for(int i = 0; i < NUM_ANALOG_INPUTS; i++)
+	{
+		values[i] = analogRead(A0 + i);
+		if(abs(values[i] - _analog[i]) > _deadband)
+		{
+			if(room >= 3)
+			{
+				analog_changes++;
+				room -= 3;
+			}
+			else
+			{
+				values[i] = _analog[i];
+			}
+		}
+	}
+	_protocol.beginFrame(OP_PIN_CHANGES, 2 + 2 * digital_changes + 3 * analog_changes);
+	_protocol.writeByte(digital_changes);
+	for(int i = 0; i < NUM_DIGITAL_PINS; i++)
+	{
+		if(pinChanged(previous, i))
+		{
+			_protocol.writeByte(i);
+			_protocol.writeByte(bitRead(_pins.powered[i / 8], i % 8) | (bitRead(_pins.high[i / 8], i % 8) << 1));
+		}
+	}
+	_protocol.writeByte(analog_changes);
+	for(int i = 0; i < NUM_ANALOG_INPUTS; i++)
+	{
+		if(abs(values[i] - _analog[i]) > _deadband)
+		{
+			_analog[i] = values[i];
+			_protocol.writeByte(i);
+			_protocol.writeByte(values[i] & 0xFF);
+			_protocol.writeByte(values[i] >> 8);
+		}
+	}
+	_protocol.endFrame();
+}
+
+/**********************************************************
+* @brief Start recording watched variables into a ring buffer.
+*
+*  Each record holds micros() followed by the raw bytes of every
+*  chosen variable.  Once the buffer is full the oldest record is
+*  overwritten.
+*
+*  @note Variables must be added before the trace begins.
+*	@param buffer RAM to record into (owned by the sketch)
+*	@param size The size of buffer in bytes
+*	@param mask Bit i selects the variable at watch index i
+*	@param period Microseconds between samples, 0 samples every trace() call
+*	@return false if a single record does not fit in the buffer
+***********************************************************/
+bool ArduinoDebugger::traceBegin(byte buffer[], unsigned int size, unsigned long mask, unsigned long period)
+{
+	_trace.begin(buffer, size, period);
+	for(byte i = 0; i < top_var_watch; i++)
+	{
+		if(i < 32 && (mask & (1UL << i)) && watching(i))
+		{
+			Variable var = _watches[i];
+			unsigned long length = (unsigned long)getNumBytes(var.type) * var.count;
+			if(length > 255 || !_trace.addChannel(var.ptr, length, i))
+			{
+				return false;
+			}
+		}
+	}
+	return _trace.start();
+}
+
+/**********************************************************
+* @brief Record a sample, place at the point being traced.
+***********************************************************/
+void ArduinoDebugger::trace()
+{
+	if(_reply != OP_DUMP_TRACE)
+	{//A sample would move the records poll() is part way through sending
+		_trace.trigger();
+	}
+}
+
+void ArduinoDebugger::traceEnd()
+{
+	_trace.stop();
+}
+
+/**********************************************************
+* @brief Send every recorded sample to the host in one transfer,
+*        the same answer as OP_DUMP_TRACE (see startReply()).
+***********************************************************/
+void ArduinoDebugger::dumpTrace()
+{
+	finishReply();
+	startReply(OP_DUMP_TRACE);
+	finishReply();
+}
+
+void ArduinoDebugger::profileEnd()
+{
+	_profile.end();
+}
+
+/**********************************************************
+* @brief Display how often each named breakpoint was reached.
+*
+*  Times are the microseconds between hits of the same breakpoint.
+***********************************************************/
+void ArduinoDebugger::displayProfile()
+{
+	drawStars();
+	_out.println(F("\t\tBreakpoint Profile"));
+	_out.println(F("name : hits, time between hits min/mean/max (us)"));
+	drawStars();
+	for(byte i = 0; i < _profile.count(); i++)
+	{
+		Probe &probe = _profile.probe(i);
+		_out.print(probe.label);
+		_out.print(F(" : "));
+		_out.print(probe.hits);
+		_out.print(F(" hits"));
+		if(probe.hits > 1)
+		{
+			_out.print(F(", "));
+			_out.print(probe.shortest);
+			_out.print(F("/"));
+			_out.print(_profile.mean(i));
+			_out.print(F("/"));
+			_out.print(probe.longest);
+			_out.print(F(" us"));
+		}
+		_out.println();
+	}
+	if(_profile.missed() > 0)
+	{
+		_out.print(_profile.missed());
+		_out.println(F(" hits of other breakpoints (profile is full)"));
+	}
+	drawStars();
+	_out.flush();
+}
+
+/**********************************************************
+* @brief Send one breakpoint of the profile to the host.
+*
+*  Payload: hits (4), shortest, mean & longest time between hits
+*  in microseconds (4 each, 0 until the second hit), name.
+***********************************************************/
+void ArduinoDebugger::sendProbe(byte index, byte most)
+{
+	Probe &probe = _profile.probe(index);
+	uint32_t values[4];
+	values[0] = probe.hits;
+	values[1] = probe.hits > 1 ? probe.shortest : 0;
+	values[2] = _profile.mean(index);
+	values[3] = probe.longest;
+	size_t length = strlen(probe.label);
+	if(length > most - sizeof(values))
+	{
+		length = most - sizeof(values);
+	}
+	_protocol.beginFrame(OP_PROFILE, sizeof(values) + length);
+	_protocol.writeBytes(values, sizeof(values));
+	_protocol.writeBytes(probe.label, length);
+	_protocol.endFrame();
+}
+
+/**********************************************************
+* @brief Compile a breakpoint condition such as "tempF > 80 && count < 100".
 *
-*  @note If the converted number causes overflow or does not fit within
-*  the set number of bytes (parameter), this method will set the parameter
-*  valid to false.
-*  
-*	 @param valid - a boolean (passed by reference)
-*	 @param type - The type of number being used
+*  The text is parsed once into a list of Terms, so breakpointIf() only
+*  compares values when the program runs.  Each term compares a watched
+*  (non array) variable against a constant using ==, !=, <, <=, > or >=.
+*  Terms are joined with &&.  Empty text clears the condition.
+*
+*	@param expression The condition to compile
+*	@return false if the condition could not be compiled, the previous
+*					condition is kept in that case.
 ***********************************************************/
-long ArduinoDebugger::getNumber(bool &valid, Type type)
+bool ArduinoDebugger::setCondition(char expression[])
 {
-	valid = true;//Assume value is valid
-	bool outRange = false;//Determine if the number is too large/small
-	char* eptr;//Points to the first character that COULD NOT be converted, may be null if all values could be converted
-  char input[12];
-  while(Serial.available() == 0) {}//Wait for value
-  int num = Serial.readBytes(input, 11);
-  input[num] = 0;//Null terminate
-	if(!_usingTerminal)
+	Term terms[DEBUG_CONDITION_TERMS];
+	byte count = 0;
+	char* pos = expression;
+	while(*pos == ' ')
 	{
-		Serial.println(input);//echo input to screen
+		pos++;
 	}
-  long result = strtol(input, &eptr, 10);//Convert user input to long
-  if(!(*eptr == 0 || *eptr == 13 || *eptr == 10))
-  {//Check if a non-numeric character was entered
-    Serial.println(F("Not a number"));
-		valid = false;
-  }
-  else if(errno == ERANGE)
-  {//Check if the value was too large for a long
+	while(*pos != 0 && *pos != '\r' && *pos != '\n')
+	{
+		if(count == DEBUG_CONDITION_TERMS)
+		{
+			return false;
+		}
+		Term term;
+		if(!parseTerm(pos, term))
+		{
+			return false;
+		}
+		terms[count] = term;
+		count++;
+		while(*pos == ' ')
+		{
+			pos++;
+		}
+		if(pos[0] == '&' && pos[1] == '&')
+		{
+			pos += 2;
+			while(*pos == ' ')
+			{
+				pos++;
+			}
+			if(*pos == 0 || *pos == '\r' || *pos == '\n')
+			{//Dangling &&
+				return false;
+			}
+		}
+		else if(*pos != 0 && *pos != '\r' && *pos != '\n')
+		{
+			return false;
+		}
+	}
+	memcpy(_terms, terms, count * sizeof(Term));
+	_num_terms = count;
+	return true;
+}
 
-    outRange = true;
+/**********************************************************
+* @brief Compile one "variable <comparison> constant" term.
+*
+*	@param pos The text to compile, moved past the term
+*	@param term Set to the compiled term
+*	@return false if the text isn't a term on a watched (non array) variable
+***********************************************************/
+bool ArduinoDebugger::parseTerm(char* &pos, Term &term)
+{
+	//Variable name
+	char* start = pos;
+	while(isalnum(*pos) || *pos == '_')
+	{
+		pos++;
 	}
-	else if(type != LONG){
-		long check = 0;
-		switch(type)
-		{//Verify the user input fits in the destination size
-			case Type::BYTE:
-				check = (byte)result; 
-				break;
-				
-			case Type::INT:
-				check = (int)result;
-				break;
-				
+	byte length = pos - start;
+	byte index = findWatch(start, length, false, hashName(start, length, false));
+	if(length == 0 || index == DEBUG_NO_WATCH || isArray(_watches[index].type))
+	{
+		return false;
+	}
+	while(*pos == ' ')
+	{
+		pos++;
+	}
+	//Comparison
+	term.index = index;
+	term.comparison = 0;
+	if(pos[0] == '=' && pos[1] == '=')
+	{
+		term.comparison = CMP_EQ;
+	}
+	else if(pos[0] == '!' && pos[1] == '=')
+	{
+		term.comparison = CMP_NE;
+	}
+	else if(pos[0] == '<')
+	{
+		term.comparison = (pos[1] == '=') ? CMP_LE : CMP_LT;
+	}
+	else if(pos[0] == '>')
+	{
+		term.comparison = (pos[1] == '=') ? CMP_GE : CMP_GT;
+	}
+	else
+	{
+		return false;
+	}
+	pos += (term.comparison == CMP_LT || term.comparison == CMP_GT) ? 1 : 2;
+	while(*pos == ' ')
+	{
+		pos++;
+	}
+	//Constant
+	if(_watches[index].type == Type::FLOAT)
+	{
+		if(!parseReal(pos, term.value.real))
+		{
+			return false;
 		}
-		if(check != result)
+	}
+	else if(strncmp(pos, "true", 4) == 0 || strncmp(pos, "false", 5) == 0)
+	{
+		term.value.whole = (*pos == 't') ? 1 : 0;
+		pos += (*pos == 't') ? 4 : 5;
+	}
+	else
+	{
+		char* end;
+		term.value.whole = strtol(pos, &end, 10);
+		if(end == pos)
 		{
-			outRange = true;
+			return false;
 		}
+		pos = end;
 	}
-	if(outRange)
+	return true;
+}
+
+/**********************************************************
+* @brief Install a condition already compiled by the host.
+*
+*  Payload: one or more (index, comparison, constant (4 bytes)) terms,
+*  the constant is a 32 bit integer or, for float variables, a float.
+*  An empty payload clears the condition.
+***********************************************************/
+bool ArduinoDebugger::setCondition(byte payload[], byte length)
+{
+	if(length % 6 != 0 || length / 6 > DEBUG_CONDITION_TERMS)
 	{
-		Serial.println(F("Value Out of Range"));
-		valid = false;
+		return false;
 	}
-	return result;
+	Term terms[DEBUG_CONDITION_TERMS];
+	byte count = length / 6;
+	for(byte i = 0; i < count; i++)
+	{
+		byte* data = payload + i * 6;
+		if(!watching(data[0]) || isArray(_watches[data[0]].type) ||
+			 data[1] < CMP_LT || data[1] > CMP_GE)
+		{
+			return false;
+		}
+		terms[i].index = data[0];
+		terms[i].comparison = data[1];
+		if(_watches[data[0]].type == Type::FLOAT)
+		{
+			memcpy(&terms[i].value.real, data + 2, 4);
+		}
+		else
+		{
+			int32_t whole;
+			memcpy(&whole, data + 2, 4);
+			terms[i].value.whole = whole;
+		}
+	}
+	memcpy(_terms, terms, count * sizeof(Term));
+	_num_terms = count;
+	return true;
 }
 
-char ArduinoDebugger::getChar()
+void ArduinoDebugger::clearCondition()
 {
-	Serial.print(F("(char): "));
-	while(Serial.available() == 0){}
-	char temp_char = Serial.read();
-	if(!_usingTerminal)
+	_num_terms = 0;
+}
+
+/**********************************************************
+* @brief Stop the program when a watched variable changes.
+*
+*  check() compares the variable against a copy taken when the
+*  watchpoint was set (a checksum for arrays & variables larger
+*  than 4 bytes), so this finds out when a variable gets clobbered.
+*
+*	@param id The watch's id (see add())
+*	@param action WATCH_HALT to stop in breakpoint() (labeled with the
+*					variable's name), WATCH_TRACE to record a trace sample
+*	@return false if id isn't watched or DEBUG_WATCHPOINTS are already set
+***********************************************************/
+bool ArduinoDebugger::watchpoint(byte id, WatchAction action)
+{
+	if(!watching(id))
 	{
-		Serial.println(temp_char);
+		return false;
 	}
-	clearBuffer();
-	clearScreen();
-	return temp_char;
+	Watchpoint point;
+	point.term.index = id;
+	point.term.comparison = 0;
+	point.action = action;
+	return addWatchpoint(point);
 }
 
+/**********************************************************
+* @brief Stop the program when a comparison on a watched variable
+*				 becomes true (Ex: "level > 100").
+*
+*  Fires when check() finds the comparison true after it was false,
+*  so a value that stays past a threshold only fires once.
+*
+*	@param expression One term, written like a breakpoint condition
+*	@param action WATCH_HALT or WATCH_TRACE, see watchpoint()
+*	@return false if the expression can't be compiled or
+*					DEBUG_WATCHPOINTS are already set
+***********************************************************/
+bool ArduinoDebugger::watchpointIf(char expression[], WatchAction action)
+{
+	Watchpoint point;
+	char* pos = expression;
+	while(*pos == ' ')
+	{
+		pos++;
+	}
+	if(!parseTerm(pos, point.term))
+	{
+		return false;
+	}
+	while(*pos == ' ')
+	{
+		pos++;
+	}
+	if(*pos != 0 && *pos != '\r' && *pos != '\n')
+	{
+		return false;
+	}
+	point.action = action;
+	return addWatchpoint(point);
+}
 
-bool ArduinoDebugger::getBool(bool &valid)
+bool ArduinoDebugger::addWatchpoint(Watchpoint &point)
 {
-	bool value = true;
-	valid = true;
-	Serial.print("(bool): ");
-	while(Serial.available() == 0){}
-	byte bool_char = Serial.peek();
-	
-	if(!_usingTerminal)
+	if(_num_watchpoints == DEBUG_WATCHPOINTS)
 	{
-		while(Serial.available() != 0)
+		return false;
+	}
+	resetWatchpoint(point);
+	_watchpoints[_num_watchpoints] = point;
+	_num_watchpoints++;
+	return true;
+}
+
+void ArduinoDebugger::clearWatchpoints()
+{
+	_num_watchpoints = 0;
+}
+
+/**********************************************************
+* @brief Test every watchpoint, place where the program should be watched.
+*
+*  Cheap enough for every pass through loop(): each watchpoint costs
+*  a memcmp() of up to 4 bytes (a checksum for larger variables) or
+*  one comparison.
+*
+*	@note check() may also be called from a timer interrupt as long as
+*  every watchpoint records trace samples (WATCH_TRACE), halting
+*  inside an interrupt would stop Serial.
+***********************************************************/
+void ArduinoDebugger::check()
+{
+	for(byte i = 0; i < _num_watchpoints; i++)
+	{
+		Watchpoint &point = _watchpoints[i];
+		bool fired;
+		if(point.term.comparison == 0)
+		{
+			fired = valueChanged(point);
+		}
+		else
+		{
+			bool met = termMet(point.term);
+			fired = met && !point.met;
+			point.met = met;
+		}
+		if(fired)
 		{
-			Serial.print((char)Serial.read());//Echo value back to Serial Monitor
+			fireWatchpoint(point);
 		}
 	}
-	
-	if(bool_char == 'F' || bool_char == 'f')
+}
+
+//Take what the watchpoint compares against from the variable's current value
+void ArduinoDebugger::resetWatchpoint(Watchpoint &point)
+{
+	if(point.term.comparison == 0)
 	{
-		value = false;
+		valueChanged(point);
 	}
-	else if(bool_char != 'T' && bool_char != 't')
+	else
 	{
-		valid = false;
-		Serial.println(F("Value must be (t)rue or (f)alse"));
+		point.met = termMet(point.term);
 	}
-	clearBuffer();
-	return value;
 }
-/**************************************************************************
-* 
-*  @brief Pause the currently running Arduino program
-*	
-*	This method will pause the arduino program and wait until the user
-*			enters a value via the Serial port to continue
-*	@note This method requires the Serial port to have a connection in order to
-*			work correctly.
-***/    
-void ArduinoDebugger::pause()
+
+//Compare a watchpoint's variable against its copy & keep the new value
+bool ArduinoDebugger::valueChanged(Watchpoint &point)
 {
-	if(Serial)
-	{//Verify the Serial port is accessible
-		Serial.println(F("Press ENTER to continue"));
-		while(Serial.available() == 0){} //Wait until input is provided on the Serial port
-		clearBuffer();
+	Variable var = _watches[point.term.index];
+	unsigned int length = getNumBytes(var.type) * var.count;
+	if(length <= sizeof(point.last.bytes))
+	{
+		if(memcmp(point.last.bytes, var.ptr, length) == 0)
+		{
+			return false;
+		}
+		memcpy(point.last.bytes, var.ptr, length);
+		return true;
+	}
+	uint16_t sum = DebugSnapshot::checksum((byte*)var.ptr, length);
+	if(sum == point.last.sum)
+	{
+		return false;
 	}
+	point.last.sum = sum;
+	return true;
 }
 
-
-/**************************************************************************
-* 
-*  @brief Clear the Serial Buffer
-*	
-*	This method will remove any characters within the Serial Buffer
-***/
-void ArduinoDebugger::clearBuffer()
-{ int flush = timedPeek();
-	while(flush != -1)
-	{//remove any remaining values from the Serial buffer
-		Serial.read();
-		flush = timedPeek();
+void ArduinoDebugger::fireWatchpoint(Watchpoint &point)
+{
+	if(point.action == WATCH_TRACE)
+	{
+		if(_trace.recording() && _reply != OP_DUMP_TRACE)
+		{
+			_trace.sample();
+		}
+		return;
+	}
+	Variable var = _watches[point.term.index];
+	byte length = nameLength(var);
+	if(length > sizeof(_watch_label) - 1)
+	{
+		length = sizeof(_watch_label) - 1;
+	}
+	for(byte i = 0; i < length; i++)
+	{
+		_watch_label[i] = nameChar(var, i);
+	}
+	_watch_label[length] = 0;
+	halt(_watch_label);//Not a profile probe, every watchpoint shares the label's buffer
+	for(byte i = 0; i < _num_watchpoints; i++)
+	{//Values changed from the menu don't fire again
+		resetWatchpoint(_watchpoints[i]);
 	}
 }
 
-/**************************************************************************
-* 
-*  @brief Clear the screen on Serial Monitor
-*	
-*	This method will "clear" the screen by feeding a series of newlines to move the
-* location in the Serial Monitor to be further down.  
-***/
-void ArduinoDebugger::clearScreen()
+/**********************************************************
+* @brief Evaluate the compiled breakpoint condition.
+*
+*	@return true when every term holds
+***********************************************************/
+bool ArduinoDebugger::conditionMet()
 {
-	if(_usingTerminal)
+	for(byte i = 0; i < _num_terms; i++)
 	{
-		Serial.write(27);
-		Serial.print(F("[2J"));// clear screen command
-		Serial.write(27);
-		Serial.print(F("[H"));
+		if(!termMet(_terms[i]))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ArduinoDebugger::termMet(const Term &term)
+{
+	Variable var = _watches[term.index];
+	byte outcome;
+	if(var.type == Type::FLOAT)
+	{//Only set from the protocol when there is no RealFormat, it never holds
+		if(_real == NULL)
+		{
+			return false;
+		}
+		outcome = _real->compare(*(float*)var.ptr, term.value.real);
 	}
 	else
 	{
-		for(int i = 0; i < 15; i++)
+		long value = readInteger(var);
+		outcome = (value < term.value.whole) ? CMP_LT : (value > term.value.whole) ? CMP_GT : CMP_EQ;
+	}
+	return (term.comparison & outcome) != 0;
+}
+
+//The value of a non float variable, or of one element of an array
+long ArduinoDebugger::readInteger(Variable var, uint16_t index)
+{
+	switch(var.type)
+	{
+		case Type::INT:
+		case Type::INT_ARRAY:
+			return ((int*)var.ptr)[index];
+			
+		case Type::LONG:
+		case Type::LONG_ARRAY:
+			return ((long*)var.ptr)[index];
+			
+		case Type::CHAR:
+		case Type::CHAR_ARRAY:
+			return ((char*)var.ptr)[index];
+			
+		case Type::BOOL:
+		case Type::BOOL_ARRAY:
+			return ((bool*)var.ptr)[index];
+			
+		default://byte
+			return ((byte*)var.ptr)[index];
+	}
+}
+
+/**********************************************************
+* @brief Let the user view & replace the breakpoint condition.
+***********************************************************/
+void ArduinoDebugger::updateCondition()
+{
+	drawStars();
+	_out.println(F("\t\tBreakpoint Condition"));
+	_out.print(F("Current: "));
+	printCondition();
+	drawStars();
+	_out.println(F("Enter a condition such as count > 5 && ready == true"));
+	_out.print(F("Condition (blank to clear): "));
+	char input[48];
+	if(readLine(input, sizeof(input)) == sizeof(input))
+	{//A cut down condition could hold at the wrong values
+		_out.println(F("Condition too long"));
+		pause();
+	}
+	else if(!setCondition(input))
+	{
+		_out.println(F("Invalid Condition"));
+		pause();
+	}
+}
+
+void ArduinoDebugger::printCondition()
+{
+	if(_num_terms == 0)
+	{
+		_out.println(F("none (breakpointIf() will not stop)"));
+		return;
+	}
+	for(byte i = 0; i < _num_terms; i++)
+	{
+		Term term = _terms[i];
+		if(i > 0)
+		{
+			_out.print(F(" && "));
+		}
+		printName(_watches[term.index]);
+		switch(term.comparison)
+		{
+			case CMP_LT: _out.print(F(" < ")); break;
+			case CMP_EQ: _out.print(F(" == ")); break;
+			case CMP_LE: _out.print(F(" <= ")); break;
+			case CMP_GT: _out.print(F(" > ")); break;
+			case CMP_NE: _out.print(F(" != ")); break;
+			case CMP_GE: _out.print(F(" >= ")); break;
+		}
+		if(_watches[term.index].type == Type::FLOAT)
 		{
-			Serial.println();
+			printReal(term.value.real);
+		}
+		else
+		{
+			_out.print(term.value.whole);
 		}
 	}
+	_out.println();
 }
 
-/***********************************************************
-* 
-*  Print a series of asterisks on the Serial monitor.
-*	
-***/
-void ArduinoDebugger::drawStars()
+/**********************************************************
+* @brief Read & print floats through the RealFormat set by
+*        ArduinoDebuggerF.  Without one floats can't be shown or changed.
+***********************************************************/
+bool ArduinoDebugger::parseReal(char* &text, float &value)
 {
-	for(int i = 0; i < 50; i++)
+	if(_real == NULL)
 	{
-		Serial.print('*');
+		if(!_usingProtocol)
+		{
+			_out.println(F(" (float): Set usingFloats to true in initalize()"));
+		}
+		return false;
 	}
-	Serial.println();
+	return _real->parse(text, value);
 }
 
-static int ArduinoDebugger::timedPeek()
+void ArduinoDebugger::printReal(float value)
 {
-  int c;
-  unsigned long startMillis = millis();
-  do {
-    c = Serial.peek();
-    if (c >= 0) return c;
-  } while(millis() - startMillis < 1000);//default timeout
-  return -1;     // -1 indicates timeout
-}
\ No newline at end of file
+	if(_real == NULL)
+	{
+		_out.print(F("Set usingFloats to true in initalize()"));
+		return;
+	}
+	_real->print(_out, value);
+}
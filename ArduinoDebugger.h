@@ -1,6 +1,85 @@
 #ifndef _ARDUINO_DEBUGGER_H_
 #define _ARDUINO_DEBUGGER_H_
 #include <Arduino.h>
+#include <DebugOutput.h>
+#include <DebugProtocol.h>
+#include <DebugTrace.h>
+#include <DebugProfile.h>
+#include <DebugSnapshot.h>
+
+//Library settings.  The library's .cpp files are compiled on their own, so a
+//#define in the sketch never reaches them: change the values here or define
+//them for the whole build (Ex: -D compiler flags).  Several of them size class
+//members, and a sketch that saw another value would disagree with the library
+//about where each member is.
+
+//Most ports read when taking a snapshot of the pins
+#ifndef DEBUG_MAX_PORTS
+#define DEBUG_MAX_PORTS 12
+#endif
+#define DEBUG_PIN_BYTES ((NUM_DIGITAL_PINS + 7) / 8)
+
+//Most comparisons joined with && in a breakpoint condition
+#ifndef DEBUG_CONDITION_TERMS
+#define DEBUG_CONDITION_TERMS 4
+#endif
+
+//Watches available to a debugger created without its own watch table
+#ifndef DEBUG_WATCHES
+#define DEBUG_WATCHES 10
+#endif
+
+//Milliseconds to wait for the next character of an unterminated line
+#ifndef DEBUG_INPUT_TIMEOUT
+#define DEBUG_INPUT_TIMEOUT 50
+#endif
+
+//Most bytes poll() reads from the port in one call (one full frame)
+#ifndef DEBUG_POLL_BYTES
+#define DEBUG_POLL_BYTES (DEBUG_MAX_PAYLOAD + 4)
+#endif
+
+//Bytes of an answer (Ex: the watch list or a trace) poll() sends per call, it stops
+//after the frame that reaches this.  No frame sent by poll() is longer.
+#ifndef DEBUG_POLL_REPLY
+#define DEBUG_POLL_REPLY 64
+#endif
+static_assert(DEBUG_POLL_REPLY >= 16, "A frame sent by poll() must hold a watch's description");
+
+//Most bytes of an array written by one bulk update (values are checked before any is written)
+#ifndef DEBUG_BULK_BYTES
+#define DEBUG_BULK_BYTES 128
+#endif
+
+//Array elements shown on one page of an array's menu
+#ifndef DEBUG_ARRAY_PAGE
+#define DEBUG_ARRAY_PAGE 16
+#endif
+
+//Elements listed by an array's summary
+#ifndef DEBUG_SUMMARY_FIRST
+#define DEBUG_SUMMARY_FIRST 8
+#endif
+
+//Most watchpoints tested by check()
+#ifndef DEBUG_WATCHPOINTS
+#define DEBUG_WATCHPOINTS 4
+#endif
+
+//Longest break-in sequence setBreakSequence() accepts
+#ifndef DEBUG_BREAK_LENGTH
+#define DEBUG_BREAK_LENGTH 8
+#endif
+
+//Counter behind millis() that setTimeCompensation() rewinds on boards other than AVR
+//(define DEBUG_MICROS_COUNTER instead for a core that counts microseconds)
+#if !defined(DEBUG_MILLIS_COUNTER) && !defined(DEBUG_MICROS_COUNTER)
+#if defined(TEENSYDUINO)
+#define DEBUG_MILLIS_COUNTER systick_millis_count
+#elif defined(ARDUINO_ARCH_STM32)
+#define DEBUG_MILLIS_COUNTER uwTick
+#endif
+#endif
 
 enum Type
 {
@@ -17,44 +96,306 @@ enum Type
 		BOOL,
 		BOOL_ARRAY
 };
+//One watch, the name isn't copied so it must outlive the watch (Ex: a string literal)
 struct Variable
 {
-	void* ptr;
-	Type type;
-	char name[16];
+	void* ptr;//NULL while the slot is free
+	const char* name;
+	uint16_t count;//Number of elements (1 for non array variables), next free slot while free
+	uint16_t hash;//debugHash() of the name
+	Type type : 4;
+	byte flash_name : 1;//name is in flash (added with F())
+	byte sized_name : 1;//name is varName_SIZE, it ends at the '_'
+};
+
+//Returned by add() when the watch table is full
+#define DEBUG_NO_WATCH 255
+
+//Hash of a watch name, add(DEBUG_WATCH(var)) works it out at compile time
+constexpr uint16_t debugHash(const char* text, uint16_t hash = 5381)
+{
+	return *text == 0 ? hash : debugHash(text + 1, (uint16_t)((hash * 33) ^ (byte)*text));
+}
+template <uint16_t hash> struct DebugHash { static const uint16_t value = hash; };
+struct WatchName
+{
+	const char* text;//In flash
+	uint16_t hash;
+};
+#define DEBUG_NAME(text) (WatchName{PSTR(text), DebugHash<debugHash(text)>::value})
+//Ex: debugger.add(DEBUG_WATCH(count)); watches count under the name "count"
+#define DEBUG_WATCH(var) var, DEBUG_NAME(#var)
+
+//Maps a C++ type to its Type values, unsupported types won't compile
+template <typename T> struct TypeOf;
+template <> struct TypeOf<byte> { static const Type single = BYTE; static const Type array = BYTE_ARRAY; };
+template <> struct TypeOf<int> { static const Type single = INT; static const Type array = INT_ARRAY; };
+template <> struct TypeOf<long> { static const Type single = LONG; static const Type array = LONG_ARRAY; };
+template <> struct TypeOf<float> { static const Type single = FLOAT; static const Type array = FLOAT_ARRAY; };
+template <> struct TypeOf<char> { static const Type single = CHAR; static const Type array = CHAR_ARRAY; };
+template <> struct TypeOf<bool> { static const Type single = BOOL; static const Type array = BOOL_ARRAY; };
+
+//One bit per digital pin, read a whole port at a time
+struct PinSnapshot
+{
+	byte powered[DEBUG_PIN_BYTES];//Output register set (providing power)
+	byte high[DEBUG_PIN_BYTES];//Input register set (reading HIGH)
+};
+
+//Each comparison is a mask of the outcomes (less/equal/greater) that satisfy it
+enum Compare
+{
+		CMP_LT = 1,
+		CMP_EQ = 2,
+		CMP_LE = 3,
+		CMP_GT = 4,
+		CMP_NE = 5,
+		CMP_GE = 6
+};
+//One "variable <comparison> constant" part of a breakpoint condition
+struct Term
+{
+	byte index;//Position of the variable in the watch list
+	byte comparison;
+	union
+	{
+		long whole;
+		float real;
+	} value;
+};
+
+//What a watchpoint does when it fires
+enum WatchAction
+{
+		WATCH_HALT,//Stop in breakpoint()
+		WATCH_TRACE//Record a trace sample (see traceBegin())
+};
+//Fires when a watched variable changes, or when its term becomes true
+struct Watchpoint
+{
+	Term term;//comparison is 0 to fire on any change
+	byte action;
+	bool met;//The term held at the previous check()
+	union
+	{
+		byte bytes[4];//Copy of a variable of up to 4 bytes
+		uint16_t sum;//Checksum of a larger variable (Ex: an array)
+	} last;
+};
+
+//Elements of one watch that changed since they were last shown
+struct ChangeRange
+{
+	byte index;//Position of the variable in the watch list
+	uint16_t start;
+	uint16_t count;
+	unsigned int block;//Next checksum to compare
+};
+
+//Every float operation beyond copying a value (parsing, printing, math &
+//comparisons).  Set by ArduinoDebuggerF, so the float code is only linked
+//into sketches that use it
+struct RealFormat
+{
+	bool (*parse)(char* &text, float &value);
+	void (*print)(Print &out, float value);
+	void (*summarize)(const float values[], uint16_t count, float &low, float &high, float &mean);
+	byte (*compare)(float value, float constant);//CMP_LT, CMP_EQ or CMP_GT
 };
 
 class ArduinoDebugger{
 public:
 	
-	ArduinoDebugger(bool isAvr, bool usingTerminal);
+	ArduinoDebugger(bool isAvr, bool usingTerminal, bool usingProtocol = false);
+	
+	//The debugger returned by Debugger::initialize() is moved into place, taking over its watch
+	//table.  Debuggers can't be copied, since the copy would share the table.
+	ArduinoDebugger(ArduinoDebugger &&other);
+	ArduinoDebugger(const ArduinoDebugger &other) = delete;
+	~ArduinoDebugger();
+	
+	//The sketch provides the watch table, its length is the most watches allowed.  The built-in
+	//table of DEBUG_WATCHES (10) is then left out of the sketch, only one debugger can use it at a time.
+	//Ex: Variable watches[4]; ArduinoDebugger debugger(watches, true, false);
+	template <size_t n>
+	ArduinoDebugger(Variable (&watches)[n], bool isAvr, bool usingTerminal, bool usingProtocol = false) : _protocol(_out)
+	{
+		static_assert(n <= 255, "A watch table holds at most 255 variables");
+		init(watches, n, isAvr, usingTerminal, usingProtocol);
+	}
 	
 	void breakpoint();
 	
 	void breakpoint(char name[]);
 	
+	//Service host commands without halting the program
+	void poll();
+	
+	//Watch the port for the break-in sequence (Ex: from serialEvent())
+	void serviceBreakIn();
+	//Start a session once the host asked to break in.
+	//Kept inline so it only costs a flag test when nothing was asked.
+	void checkpoint()
+	{
+		if(_break_in)
+		{
+			breakIn();
+		}
+	}
+	
+	//Halt only while the condition set with setCondition() holds.
+	//Kept inline so a condition that isn't met costs only a few compares.
+	void breakpointIf(char name[])
+	{
+		if(_num_terms != 0 && conditionMet())
+		{
+			breakpoint(name);
+		}
+	}
+	bool setCondition(char expression[]);
+	void clearCondition();
+	void updateCondition();
+	
 	//Idea allow student to choose subset of digital & analog pins
 	//template <size_t n>
 	//void breakpoint(char name[], byte (&digital)[n], byte (&analog)[n]);
 	
-	void add(void* var_ptr, Type type, char var_name[]);
+	//The type (and length of arrays) is worked out by the compiler.
+	//Names given with F() or DEBUG_NAME() stay in flash.
+	//Returns the watch's id (its index in the watch table), which never changes
+	//while the variable is watched, or DEBUG_NO_WATCH if the table is full.
+	template <typename T>
+	byte add(T &var, char var_name[])
+	{
+		return addWatch(&var, TypeOf<T>::single, 1, var_name, false, hashName(var_name, strlen(var_name), false));
+	}
+	template <typename T, size_t n>
+	byte add(T (&var)[n], char var_name[])
+	{
+		return addWatch(var, TypeOf<T>::array, n, var_name, false, hashName(var_name, strlen(var_name), false));
+	}
+	template <typename T>
+	byte add(T &var, const __FlashStringHelper* var_name)
+	{
+		return addWatch(&var, TypeOf<T>::single, 1, (const char*)var_name, true, hashName((const char*)var_name, strlen_P((const char*)var_name), true));
+	}
+	template <typename T, size_t n>
+	byte add(T (&var)[n], const __FlashStringHelper* var_name)
+	{
+		return addWatch(var, TypeOf<T>::array, n, (const char*)var_name, true, hashName((const char*)var_name, strlen_P((const char*)var_name), true));
+	}
+	template <typename T>
+	byte add(T &var, WatchName var_name)
+	{
+		return addWatch(&var, TypeOf<T>::single, 1, var_name.text, true, var_name.hash);
+	}
+	template <typename T, size_t n>
+	byte add(T (&var)[n], WatchName var_name)
+	{
+		return addWatch(var, TypeOf<T>::array, n, var_name.text, true, var_name.hash);
+	}
+	
+	//Arrays must be named varName_SIZE (Ex: pins_20)
+	byte add(void* var_ptr, Type type, char var_name[]);
+	
+	//Point a watch at a new copy of its variable (Ex: a local that went out of scope),
+	//false when the id isn't watched or the type or array length differs
+	template <typename T>
+	bool updateWatch(byte id, T &var)
+	{
+		return moveWatch(id, &var, TypeOf<T>::single, 1);
+	}
+	template <typename T, size_t n>
+	bool updateWatch(byte id, T (&var)[n])
+	{
+		return moveWatch(id, var, TypeOf<T>::array, n);
+	}
 	
 	//necessary when dealing with variables that go out of scope!
 	void remove(char var_name[]);
+	void remove(const __FlashStringHelper* var_name);
+	void removeWatch(byte id);
+	
+	//The id of a watched variable, DEBUG_NO_WATCH if it isn't watched
+	byte find(char var_name[]);
+	byte find(WatchName var_name);
+	
+	//Changes whenever a watch is added or removed (sent to the host with the watch table)
+	byte generation();
 
 	void displayPins();
-	void displayPins(byte digital_pins[], byte analog_pins[]);
+	void displayPins(byte digital_pins[], byte num_digital, byte analog_pins[], byte num_analog);
+	template <size_t d, size_t a>
+	void displayPins(byte (&digital_pins)[d], byte (&analog_pins)[a])
+	{
+		displayPins(digital_pins, d, analog_pins, a);
+	}
+	bool pinsChanged();
+	void displayPinChanges();
+	void setPinDelta(bool enabled, int deadband = 4);
 	void updatePins();
 	
-	virtual void displayVariables();
-	virtual void updateVariables();
+	void displayVariables();
+	void updateVariables();
 	
-	void updateTimer();
+	//Views of a watched array that don't print every element
+	void displayElements(byte id, uint16_t start, uint16_t count);
+	void displaySummary(byte id);
+	
+	//Make the variable menu show only values that changed since they were last shown,
+	//sums needs one entry per variable plus one per DEBUG_SNAPSHOT_BLOCK array elements
+	template <size_t n>
+	void snapshotBegin(uint16_t (&sums)[n])
+	{
+		_snapshot.begin(sums, n);
+	}
+	void snapshotEnd();
+	void displayChanges();
+	
+	//Stop (or record a trace sample) when a watched variable changes, or when a
+	//comparison on one becomes true (Ex: "level > 100"), tested by check()
+	bool watchpoint(byte id, WatchAction action = WATCH_HALT);
+	bool watchpointIf(char expression[], WatchAction action = WATCH_HALT);
+	void clearWatchpoints();
+	void check();
+	
+	//Microseconds spent halted in breakpoints (in total & by the previous breakpoint)
+	unsigned long haltedTime();
+	unsigned long lastHaltTime();
+	//Take the time spent halted off millis() & micros() when a breakpoint continues,
+	//false if the board's timer can't be rewound
+	bool setTimeCompensation(bool enabled);
+	
+	//Record watched variables into a RAM ring buffer
+	bool traceBegin(byte buffer[], unsigned int size, unsigned long mask = 0xFFFFFFFF, unsigned long period = 0);
+	void trace();
+	void traceEnd();
+	void dumpTrace();
+	
+	//Count hits of named breakpoints (and time between them) instead of halting
+	template <size_t n>
+	void profileBegin(Probe (&probes)[n])
+	{
+		static_assert(n <= 255, "A profile holds at most 255 breakpoints");
+		_profile.begin(probes, n);
+	}
+	void profileEnd();
+	void displayProfile();
 	
 	void clearBuffer();
+	void setTerminator(char terminator);
+	void setInputTimeout(unsigned int timeout);
+	void setPort(Stream &port);
+	
+	//Bytes serviceBreakIn() watches for instead of an OP_BREAK frame (Ex: "!!!" for the Serial Monitor),
+	//false if there are none or more than DEBUG_BREAK_LENGTH
+	bool setBreakSequence(const byte sequence[], byte length);
+	bool setBreakSequence(const char sequence[]);
 	
 	//Get data type values from Serial Input
 	long getNumber(bool &valid, Type type);
+	long parseNumber(char input[], bool &valid, Type type);
+	float getFloat(bool &valid);
 	char getChar();
 	bool getBool(bool &valid);
 	void pause();
@@ -63,23 +404,171 @@ public:
 	
 	void drawStars();
 	
+	//Bytes sent for the previous screen (between calls to clearScreen())
+	unsigned long lastScreenBytes();
+	
 protected:
-	//variable watch
-	Variable var_watch[10];
-	byte top_var_watch = 0;
+	//Moving a debugger copies everything but _protocol's output, see the move constructor
+	ArduinoDebugger& operator=(const ArduinoDebugger &other) = default;
+	
+	//variable watch, the sketch's table or the built-in one
+	Variable* _watches;
+	byte _watch_capacity;
+	byte top_var_watch = 0;//Slots used so far, removed watches leave free slots below
+	byte _free_watch = DEBUG_NO_WATCH;//First free slot, the rest are chained through count
+	byte _generation = 0;
+	bool watching(byte id)
+	{
+		return id < top_var_watch && _watches[id].ptr != NULL;
+	}
+	bool moveWatch(byte id, void* ptr, Type type, uint16_t count)
+	{
+		if(!watching(id) || _watches[id].type != type || _watches[id].count != count)
+		{
+			return false;
+		}
+		_watches[id].ptr = ptr;
+		_trace.moveChannels(id, ptr);
+		return true;
+	}
+	void forgetWatch(byte id);
+	void init(Variable watches[], byte capacity, bool isAvr, bool usingTerminal, bool usingProtocol);
 	
 	bool _isAvr;
 	bool _usingTerminal;
+	bool _usingProtocol;
+	
+	//Port used for input & output, Serial unless changed by setPort()
+	Stream* _port = &Serial;
+	int _port_room = 0;//Most room the port has reported, see portHasRoom()
+	bool portHasRoom(unsigned int length);
+	
+	//All output is collected here & sent to the port in chunks
+	DebugOutput _out;
+	unsigned long _screen_bytes = 0;
+	void waitForInput();
+	
+	//Binary protocol (used instead of the text menus when _usingProtocol is set)
+	DebugProtocol _protocol;
+	void protocolBreakpoint(char name[]);
+	void halt(char name[]);
+	
+	//Break-in, the flag may be set from an interrupt
+	volatile bool _break_in = false;
+	byte _break_sequence[DEBUG_BREAK_LENGTH];
+	byte _break_length = 0;
+	byte _break_matched = 0;//Bytes of _break_sequence seen so far
+	byte breakFallback(byte matched);
+	void breakIn();
+	bool handleFrame();
+	void sendWatch(byte index, byte most);
+	
+	//Answer to a read, sent a piece per poll() or all at once while halted
+	byte _reply = 0;//Command being answered, 0 when there is none
+	byte _reply_generation;
+	unsigned long _reply_position;
+	ChangeRange _reply_range;
+	void startReply(byte opcode);
+	void replyFrame(byte most);
+	void finishReply();
+	void sendValues(byte payload[], byte length, byte most);
+	void sendValue(byte payload[], byte length, byte most);
+	void writeValue(byte payload[], byte length);
+	void sendPins();
+	void sendPinChanges(byte payload[], byte length, byte most);
+	
+	//Halt time accounting
+	unsigned long _halt_start = 0;
+	unsigned long _halted = 0;
+	unsigned long _last_halt = 0;
+	bool _compensate = false;
+	unsigned int _millis_carry = 0;//Microseconds not yet taken off millis()
+	unsigned int _micros_carry = 0;
+	void updateTimer();
+	
+	DebugTrace _trace;
+	DebugSnapshot _snapshot;
+	bool nextChange(ChangeRange &range);
+	void displayVariableView();
+	void printElement(const Variable &var, uint16_t index);
+	DebugProfile _profile;
+	void sendProbe(byte index, byte most);
+	
+	//Breakpoint condition, compiled by setCondition()
+	Term _terms[DEBUG_CONDITION_TERMS];
+	byte _num_terms = 0;
+	bool conditionMet();
+	bool termMet(const Term &term);
+	bool parseTerm(char* &pos, Term &term);
+	
+	//Data watchpoints
+	Watchpoint _watchpoints[DEBUG_WATCHPOINTS];
+	byte _num_watchpoints = 0;
+	char _watch_label[16];//Name of the variable that fired, the breakpoint's label
+	bool addWatchpoint(Watchpoint &point);
+	void resetWatchpoint(Watchpoint &point);
+	bool valueChanged(Watchpoint &point);
+	void fireWatchpoint(Watchpoint &point);
+	bool setCondition(byte payload[], byte length);
+	void printCondition();
+	long readInteger(Variable var, uint16_t index = 0);
+	
+	//Float support, NULL unless set by ArduinoDebuggerF
+	const RealFormat* _real = NULL;
+	bool parseReal(char* &text, float &value);
+	void printReal(float value);
+	
+	byte addWatch(void* var_ptr, Type type, uint16_t count, const char* var_name, bool in_flash, uint16_t hash, bool sized = false);
+	byte findWatch(const char* var_name, byte length, bool in_flash, uint16_t hash);
+	void removeNamed(const char* var_name, bool in_flash);
+	
+	//Names are read through these since they may be in flash
+	static uint16_t hashName(const char* text, byte length, bool in_flash);
+	char nameChar(const Variable &var, byte position);
+	byte nameLength(const Variable &var);
+	bool nameMatches(const Variable &var, const char* text, byte length, bool in_flash);
+	void printName(const Variable &var);
 	
 	//Array helper methods
-	void printName(char name[]);
-	byte getSize(char name[]);
+	uint16_t getSize(char name[]);
 	byte getNumBytes(Type type);
-	virtual void displayArray(Variable var);
-	virtual void updateArray(Variable var);
+	bool isArray(Type type);
+	
+	//Pin helper methods
+	PinSnapshot _pins;
+	void readPins(PinSnapshot &snapshot);
+	void printDigitalPin(int pin);
+	void printAnalogPin(int pin, int value);
+	bool pinChanged(PinSnapshot &previous, int pin);
+	void displayPinView();
+	
+	//Pin change view, compares against the values last shown/sent
+	bool _pin_delta = false;
+	int _deadband = 4;
+	int _analog[NUM_ANALOG_INPUTS];
+	void displayArray(Variable var, uint16_t start, uint16_t count);
+	void updateArray(Variable var);
+	void displaySummary(Variable var);
+	void displayArrayView(Variable var, uint16_t start, bool summary);
+	void arrayCommand(Variable var, uint16_t &start, bool &summary);
+	uint16_t windowEnd(const Variable &var, uint16_t start, uint16_t count);
+	void printWindow(const Variable &var, uint16_t start, uint16_t end);
+	void updateArrayBulk(Variable var);
+	bool parseElement(Type type, char text[], byte element[]);
+	
+	byte getSelection(const char commands[] = NULL);
+	uint16_t getIndex(const char commands[] = NULL);
+	char _command = 0;//Letter entered at the last menu accepting commands
+	
+//Letters accepted by an array's menu (see arrayCommand())
+#define DEBUG_ARRAY_COMMANDS "BNPS"
 	
-	byte getSelection();
-	int timedPeek();
+	//Line input
+	char _terminator = '\n';
+	char _last_char = 0;
+	unsigned int _input_timeout = DEBUG_INPUT_TIMEOUT;
+	byte readLine(char buffer[], byte size);
+	byte readToken(char buffer[], byte size, char delimiter);
 	
 };
 
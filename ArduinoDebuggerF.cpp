@@ -1,347 +1,187 @@
 #include <ArduinoDebuggerF.h>
-#include <stdlib.h>
-#include <errno.h>
-#include <stdio.h>
 #include <string.h>
+#include <ctype.h>
+#include <float.h>
 
+const RealFormat ArduinoDebuggerF::floats = {parseFloat, printFloat, summarizeFloats, compareFloats};
 
-/**********************************************************
-* @brief Display all variables being watched with their current values.
-*
-*  This method will display each of the variables (w/ their values) 
-*  that have been added to the watch list (via addWatch() method).  This
-*	 method will then allow the user to update any of the watched variables.
-*  
-*	 
-***********************************************************/
-void ArduinoDebuggerF::displayVariables()
+//Multiply by 10^exponent, by the powers of 10 for each bit of the exponent
+static float scaleReal(float value, int exponent)
 {
-	Serial.println(F("\t\tVariable Watch\n\t[index] variable_name (type) : value"));
-	drawStars();
-	for(int i =0; i < top_var_watch; i++)
+	static const float powers[] = {1e1f, 1e2f, 1e4f, 1e8f, 1e16f, 1e32f};
+	bool divide = exponent < 0;
+	if(divide)
 	{
-		 Variable temp = var_watch[i];
-		 Serial.print(F("["));
-		 Serial.print(i);
-		 Serial.print(F("] "));
-		 switch(temp.type)
-		 {		
-				case Type::BYTE:
-				  Serial.print(temp.name);
-					Serial.print(F(" (byte): "));
-					Serial.println(*((byte*)temp.ptr));
-					break;
-				
-				case Type::BYTE_ARRAY:
-					printName(temp.name);
-					Serial.print(F(" (byte["));
-					Serial.print(getSize(temp.name));
-					Serial.println(F("] : Select to view"));
-					break;
-					
-				case Type::INT:
-					Serial.print(temp.name);
-					Serial.print(F(" (int): "));
-					Serial.println(*((int*)temp.ptr));
-					break;
-				
-				case Type::INT_ARRAY:
-					printName(temp.name);
-					Serial.print(F(" (int["));
-					Serial.print(getSize(temp.name));
-					Serial.println(F("] : Select to view"));
-					break;				
-					
-				case Type::LONG:
-					Serial.print(temp.name);
-					Serial.print(F(" (long): "));
-					Serial.println(*((long*)temp.ptr));
-					break;
-					 
-				case Type::LONG_ARRAY:
-					printName(temp.name);
-					Serial.print(F(" (long["));
-					Serial.print(getSize(temp.name));
-					Serial.println(F("] : Select to view"));
-					break;
-					
-				case Type::FLOAT:
-					Serial.print(temp.name);
-					Serial.print(F(" (float): "));
-					Serial.println(*((float*)temp.ptr));
-					break;
-					
-				case Type::FLOAT_ARRAY:
-					printName(temp.name);
-					Serial.print(F(" (float["));
-					Serial.print(getSize(temp.name));
-					Serial.println(F("] : Select to view"));
-					break;
-								
-				case Type::CHAR:
-					Serial.print(temp.name);
-					Serial.print(F(" (char): "));
-					Serial.println(*((char*)temp.ptr));
-					break;
-					
-				case Type::CHAR_ARRAY:
-					printName(temp.name);
-					Serial.print(F(" (char["));
-					Serial.print(getSize(temp.name));
-					Serial.println(F("] : Select to view"));
-					break;
-					
-				case Type::BOOL:
-					Serial.print(temp.name);
-					if(*(bool*)(temp.ptr))
-					{
-					Serial.print(F(" (bool): true"));
-					}
-					else
-					{
-						Serial.print(F(" (false): true"));
-					}
-					break;
-					
-				case Type::BOOL_ARRAY:
-					printName(temp.name);
-					Serial.print(F(" (bool["));
-					Serial.print(getSize(temp.name));
-					Serial.println(F("] : Select to view"));
-					break;
-		 }
+		exponent = -exponent;
+	}
+	for(byte i = 0; i < 6; i++, exponent >>= 1)
+	{
+		if(exponent & 1)
+		{
+			value = divide ? value / powers[i] : value * powers[i];
+		}
 	}
-	drawStars();
+	if(exponent != 0)
+	{//Beyond 10^63, nothing left that fits a float
+		value = divide ? 0 : value * powers[5] * powers[5];
+	}
+	return value;
 }
 
 /**********************************************************
-* @brief Prompt the user for the value to update the chosen variable to.
+* @brief Convert text to a float without atof() or strtod().
+*
+*  Accepts an optional sign, digits with an optional decimal point and an
+*  optional exponent (Ex: -1.5e3), or 0x followed by up to 8 hex digits
+*  holding the float's raw IEEE bits (Ex: 0x41AC0000 is 21.5).
 *
-*  This method will prompt the user for a new value to use for a chosen
-*  variable and validate the new value. and 
+*  @note text is left alone when it doesn't start with a number.  It is
+*  moved past a number too large for a float, which still returns false.
 *
-*  @note The variable is only updated if a valid value is entered.
-*  Invalid values will cause error messages to be displayed.
-*  
-*	 @param index The index of the variable to update
+*	 @param text - The text to convert, moved past the number
+*	 @param value - Set to the number
 ***********************************************************/
-void ArduinoDebuggerF::updateVariables()
+bool ArduinoDebuggerF::parseFloat(char* &text, float &value)
 {
-	displayVariables();
-	byte index = getSelection();
-	while(index != 255)
+	char* pos = text;
+	while(*pos == ' ' || *pos == '\t')
 	{
-		if(index < top_var_watch && index != 254)
-		{//Verify valid index was chosen
-			Variable temp = var_watch[index];
-			bool valid = true;
-			long retrieved_val = 0;
-			if(temp.type == Type::BYTE_ARRAY || 
-				 temp.type == Type::INT_ARRAY ||
-				 temp.type == Type::LONG_ARRAY ||
-				 temp.type == Type::FLOAT_ARRAY ||
-				 temp.type == Type::CHAR_ARRAY ||
-				 temp.type == Type::BOOL_ARRAY)
-			{
-				updateArray(temp);
-			}
-			else
-			{
-				Serial.print(F("New value for "));
-				Serial.print(temp.name);
-				switch(temp.type)
-				{					
-					case Type::BYTE:
-						Serial.print("(byte): ");
-						retrieved_val = getNumber(valid, Type::BYTE);
-						if(valid)
-						{
-							clearScreen();
-							*(byte*)(temp.ptr) = (byte) retrieved_val;
-						}
-						break;
-					
-					case Type::INT:
-						Serial.print("(int): ");
-						retrieved_val = getNumber(valid, Type::INT);
-						if(valid)
-						{
-							clearScreen();
-							*(int*)(temp.ptr) = (int) retrieved_val;
-						}
-						break;
-						
-					case Type::LONG:
-						Serial.print("(long): ");
-						retrieved_val = getNumber(valid, Type::LONG);
-						if(valid)
-						{
-							clearScreen();
-							*(long*)(temp.ptr) = (long) retrieved_val;
-						}
-						break;
-						
-					case Type::FLOAT: 
-							*(float*)(temp.ptr) = getFloat();
-							clearScreen();
-						break;
-
-					case Type::CHAR:
-						*(char*)(temp.ptr) = getChar();
-						break;
-						
-					case Type::BOOL: 
-						bool temp_bool = getBool(valid);
-						if(valid)
-						{
-							clearScreen();
-							*(bool*)(temp.ptr) = temp_bool;
-						}
-						break;
-				}
-			}
+		pos++;
+	}
+	if(pos[0] == '0' && (pos[1] == 'x' || pos[1] == 'X'))
+	{//Raw IEEE bits
+		pos += 2;
+		uint32_t bits = 0;
+		byte count = 0;
+		for(; isxdigit(*pos) && count < 8; pos++, count++)
+		{
+			bits = (bits << 4) | (isdigit(*pos) ? *pos - '0' : (*pos | 0x20) - 'a' + 10);
 		}
-		else
+		if(count == 0 || isxdigit(*pos))
 		{
-			Serial.println(F("Invalid Selection"));
+			return false;
+		}
+		float raw;
+		memcpy(&raw, &bits, sizeof(raw));
+		text = pos;
+		if(raw != raw || raw > FLT_MAX || raw < -FLT_MAX)
+		{//NaN or infinity
+			return false;
 		}
-		displayVariables();
-		index = getSelection();
+		value = raw;
+		return true;
 	}
-}
-
-void ArduinoDebuggerF::displayArray(Variable var)
-{
-	drawStars();
-	printName(var.name);
-	Serial.println(F(" [index] : value "));
-	byte size = getSize(var.name);
-	for(byte i = 0; i < size; i++ )
+	bool negative = *pos == '-';
+	if(*pos == '-' || *pos == '+')
 	{
-		Serial.print(F("["));
-		Serial.print(i);
-		Serial.println(F("]: "));
-		switch(var.type)
+		pos++;
+	}
+	//The first 9 significant digits fit in an unsigned long, later ones only move the decimal point
+	unsigned long digits = 0;
+	byte significant = 0;
+	int exponent = 0;
+	bool found = false;
+	for(; isdigit(*pos); pos++)
+	{
+		found = true;
+		if(significant < 9)
+		{
+			digits = digits * 10 + (*pos - '0');
+			significant += digits != 0;
+		}
+		else
 		{
-			case Type::BYTE_ARRAY:
-				Serial.println(((byte*)var.ptr)[i]);
-				break;
-				
-			case Type::INT_ARRAY:
-				Serial.println(((int*)var.ptr)[i]);
-				break;
-				
-			case Type::LONG_ARRAY:
-				Serial.println(((long*)var.ptr)[i]);
-				break;
-			
-			case Type::FLOAT_ARRAY:
-				Serial.println(((float*)var.ptr)[i]);
-				break;
-	
-			case Type::CHAR_ARRAY:
-				Serial.println(((char*)var.ptr)[i]);
-				break;
-				
-			case Type::BOOL_ARRAY:
-			  if(((bool*)var.ptr)[i])
-				{
-					Serial.println(F("true"));
-				}
-				else
-				{
-					Serial.println(F("false"));
-				}
-				break;
+			exponent++;
 		}
 	}
-}
-
-void ArduinoDebuggerF::updateArray(Variable var)
-{
-	displayArray(var);
-	byte index = getSelection();
-	while(index != 255 )
+	if(*pos == '.')
 	{
-		byte size = getSize(var.name);
-		if(index < size && index != 254)
+		for(pos++; isdigit(*pos); pos++)
 		{
-			bool valid = true;
-			long retrieved_val = 0;
-			Serial.print(F("New value for ["));
-			Serial.print(index);
-			Serial.println(F("]: "));
-			switch(var.type)
+			found = true;
+			if(significant < 9)
 			{
-				case Type::BYTE_ARRAY:
-					retrieved_val = getNumber(valid, Type::BYTE);
-					if(valid)
-					{
-						clearScreen();
-						((byte*)var.ptr)[index] = (byte)retrieved_val;
-					}
-					break;
-					
-				case Type::INT_ARRAY:
-					retrieved_val = getNumber(valid, Type::INT);
-					if(valid)
-					{
-						clearScreen();
-						((int*)var.ptr)[index] = (int)retrieved_val;
-					}
-					break;
-					
-				case Type::LONG_ARRAY:
-					retrieved_val = getNumber(valid, Type::LONG);
-					if(valid)
-					{
-						clearScreen();
-						((long*)var.ptr)[index] = (long)retrieved_val;
-					}
-					break;
-				
-				case Type::FLOAT_ARRAY:
-					((float*)var.ptr)[index] = getFloat();
-					clearScreen();
-					break;
-				
-				case Type::CHAR_ARRAY:
-						((char*)var.ptr)[index]  = getChar();
-						break;
-					
-				case Type::BOOL_ARRAY: 
-					bool temp_bool = getBool(valid);
-					if(valid)
-					{
-						clearScreen();
-						((bool*)var.ptr)[index] = temp_bool;
-					}
-					break;
+				digits = digits * 10 + (*pos - '0');
+				significant += digits != 0;
+				exponent--;
 			}
 		}
-		else
+	}
+	if(!found)
+	{
+		return false;
+	}
+	if(*pos == 'e' || *pos == 'E')
+	{
+		pos++;
+		bool negative_exponent = *pos == '-';
+		if(*pos == '-' || *pos == '+')
 		{
-			Serial.println(F("Invalid Selection"));
+			pos++;
 		}
-		displayArray(var);
-	  index = getSelection();
+		if(!isdigit(*pos))
+		{//Ex: 1e
+			return false;
+		}
+		int power = 0;
+		for(; isdigit(*pos); pos++)
+		{
+			if(power < 1000)
+			{
+				power = power * 10 + (*pos - '0');
+			}
+		}
+		exponent += negative_exponent ? -power : power;
+	}
+	float result = digits == 0 ? 0 : scaleReal(digits, exponent);
+	text = pos;
+	if(result > FLT_MAX)
+	{
+		return false;
 	}
-	
-}				
-				
-				
+	value = negative ? -result : result;
+	return true;
+}
 
-float ArduinoDebuggerF::getFloat()
+/**********************************************************
+* @brief Print a float, or its raw IEEE bits (Ex: 0x41AC0000) when the
+*        library is built with DEBUG_RAW_FLOATS defined.
+***********************************************************/
+void ArduinoDebuggerF::printFloat(Print &out, float value)
 {
-	char input[12];
-  while(Serial.available() == 0) {}//Wait for value
-  int num = Serial.readBytes(input, 11);
-  input[num] = 0;//Null terminate
-	if(!_usingTerminal)
+#ifdef DEBUG_RAW_FLOATS
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	out.print(F("0x"));
+	for(int8_t shift = 28; shift >= 0; shift -= 4)
 	{
-		Serial.println(input);//echo input to screen
+		out.write("0123456789ABCDEF"[(bits >> shift) & 0xF]);
 	}
-	float result = atof(input);//Convert user input to float
-	//NOTE: Arduino does not support strtof, cannot easily validate float input
-	return result;
+#else
+	out.print(value);
+#endif
+}
+
+/**********************************************************
+* @brief The smallest, largest & mean values of a float array, for
+*        ArduinoDebugger::displaySummary().
+***********************************************************/
+void ArduinoDebuggerF::summarizeFloats(const float values[], uint16_t count, float &low, float &high, float &mean)
+{
+	low = values[0];
+	high = values[0];
+	float total = 0;
+	for(uint16_t i = 0; i < count; i++)
+	{
+		low = (values[i] < low) ? values[i] : low;
+		high = (values[i] > high) ? values[i] : high;
+		total += values[i];
+	}
+	mean = total / count;
+}
+
+//How a float compares to a breakpoint condition's constant
+byte ArduinoDebuggerF::compareFloats(float value, float constant)
+{
+	return (value < constant) ? CMP_LT : (value > constant) ? CMP_GT : CMP_EQ;
 }
\ No newline at end of file
@@ -2,15 +2,29 @@
 #define _ARDUINO_DEBUGGER_F_H_
 #include <Arduino.h>
 #include <ArduinoDebugger.h>
+
+//Build the library with DEBUG_RAW_FLOATS defined to show floats as their raw
+//IEEE bits (Ex: 0x41AC0000) instead of formatting them on the board
+
+//ArduinoDebugger that can show & update floats.  It only adds the float
+//parser & printer, so an ArduinoDebugger it is moved into keeps them.
 class ArduinoDebuggerF : public ArduinoDebugger{
 public:
-  void displayVariables();
-	void updateVariables();
-	ArduinoDebuggerF(bool isAvr, bool usingTerminal) : ArduinoDebugger(isAvr, usingTerminal){};
+	ArduinoDebuggerF(bool isAvr, bool usingTerminal, bool usingProtocol = false) : ArduinoDebugger(isAvr, usingTerminal, usingProtocol)
+	{
+		_real = &floats;
+	}
+	template <size_t n>
+	ArduinoDebuggerF(Variable (&watches)[n], bool isAvr, bool usingTerminal, bool usingProtocol = false) : ArduinoDebugger(watches, isAvr, usingTerminal, usingProtocol)
+	{
+		_real = &floats;
+	}
 
 private:
-  float getFloat();	
-	void displayArray(Variable var);
-	void updateArray(Variable var);
+	static const RealFormat floats;
+	static bool parseFloat(char* &text, float &value);
+	static void printFloat(Print &out, float value);
+	static void summarizeFloats(const float values[], uint16_t count, float &low, float &high, float &mean);
+	static byte compareFloats(float value, float constant);
 };
-#endif
\ No newline at end of file
+#endif
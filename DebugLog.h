@@ -0,0 +1,155 @@
+#ifndef _DEBUG_LOG_H_
+#define _DEBUG_LOG_H_
+#include <Arduino.h>
+#include <ArduinoDebugger.h>
+
+//Log levels, messages above DEBUG_LOG_LEVEL are removed by the preprocessor
+#define DEBUG_LEVEL_NONE 0
+#define DEBUG_LEVEL_ERROR 1
+#define DEBUG_LEVEL_WARN 2
+#define DEBUG_LEVEL_INFO 3
+#define DEBUG_LEVEL_DEBUG 4
+
+//Define before including DebugLog.h to choose which messages are compiled
+#ifndef DEBUG_LOG_LEVEL
+#define DEBUG_LOG_LEVEL DEBUG_LEVEL_INFO
+#endif
+
+//Port the frames are written to (Ex: define as Serial1 to keep logs off Serial)
+#ifndef DEBUG_LOG_PORT
+#define DEBUG_LOG_PORT Serial
+#endif
+
+//Longest string argument sent, longer text is cut short
+#ifndef DEBUG_LOG_TEXT
+#define DEBUG_LOG_TEXT 32
+#endif
+
+//Sends log messages without formatting them: a LOG frame holds the message's
+//id (the hash of its level & format string, worked out at compile time) and
+//the raw bytes of each argument.  extras/tools/debug_log.py builds the table
+//of messages from the sketch's source and turns the frames back into text.
+//Frames are written straight to DEBUG_LOG_PORT, nothing is buffered.
+class DebugLog{
+public:
+
+	template <typename... Args>
+	static void send(uint16_t id, Args... args)
+	{
+		static_assert(2 + MostBytes<Args...>::value <= 255,
+			"Log arguments don't fit one frame (each string takes up to DEBUG_LOG_TEXT + 1 bytes)");
+		byte length = 2 + argBytes(args...);
+		byte sum = length + OP_LOG;
+		DEBUG_LOG_PORT.write(DEBUG_FRAME_SYNC);
+		DEBUG_LOG_PORT.write(length);
+		DEBUG_LOG_PORT.write(OP_LOG);
+		writeBytes(sum, &id, sizeof(id));
+		writeArgs(sum, args...);
+		DEBUG_LOG_PORT.write((byte)(0 - sum));
+	}
+
+private:
+	//Most bytes the arguments can take, checked so the frame's length can't wrap
+	template <typename T> struct MostArgBytes { static const unsigned int value = sizeof(T); };
+	template <typename... Args> struct MostBytes { static const unsigned int value = 0; };
+	template <typename T, typename... Rest> struct MostBytes<T, Rest...>
+	{
+		static const unsigned int value = MostArgBytes<T>::value + MostBytes<Rest...>::value;
+	};
+
+	//Arguments are sent as their own bytes, strings up to DEBUG_LOG_TEXT characters & a 0
+	static byte argBytes()
+	{
+		return 0;
+	}
+	template <typename T, typename... Rest>
+	static byte argBytes(T, Rest... rest)
+	{
+		return sizeof(T) + argBytes(rest...);
+	}
+	template <typename... Rest>
+	static byte argBytes(const char* text, Rest... rest)
+	{
+		return textLength(text) + 1 + argBytes(rest...);
+	}
+	template <typename... Rest>
+	static byte argBytes(char* text, Rest... rest)
+	{
+		return textLength(text) + 1 + argBytes(rest...);
+	}
+
+	static void writeArgs(byte &)
+	{
+	}
+	template <typename T, typename... Rest>
+	static void writeArgs(byte &sum, T value, Rest... rest)
+	{
+		writeBytes(sum, &value, sizeof(T));
+		writeArgs(sum, rest...);
+	}
+	template <typename... Rest>
+	static void writeArgs(byte &sum, const char* text, Rest... rest)
+	{
+		writeBytes(sum, text, textLength(text));
+		DEBUG_LOG_PORT.write((byte)0);
+		writeArgs(sum, rest...);
+	}
+	template <typename... Rest>
+	static void writeArgs(byte &sum, char* text, Rest... rest)
+	{
+		writeArgs(sum, (const char*)text, rest...);
+	}
+
+	static byte textLength(const char* text)
+	{
+		byte length = 0;
+		while(length < DEBUG_LOG_TEXT && text[length] != 0)
+		{
+			length++;
+		}
+		return length;
+	}
+
+	static void writeBytes(byte &sum, const void* data, byte length)
+	{
+		const byte* bytes = (const byte*)data;
+		for(byte i = 0; i < length; i++)
+		{
+			sum += bytes[i];
+		}
+		DEBUG_LOG_PORT.write(bytes, length);
+	}
+};
+
+template <> struct DebugLog::MostArgBytes<const char*> { static const unsigned int value = DEBUG_LOG_TEXT + 1; };
+template <> struct DebugLog::MostArgBytes<char*> { static const unsigned int value = DEBUG_LOG_TEXT + 1; };
+
+#define DEBUG_LOG_SEND(level, format, ...) DebugLog::send(DebugHash<debugHash(level ":" format)>::value, ##__VA_ARGS__)
+
+//Ex: DEBUG_LOG_INFO("speed %d, target %d", speed, target);
+//The format must be a string literal & match the arguments' sizes (see debug_log.py)
+#if DEBUG_LOG_LEVEL >= DEBUG_LEVEL_ERROR
+#define DEBUG_LOG_ERROR(format, ...) DEBUG_LOG_SEND("E", format, ##__VA_ARGS__)
+#else
+#define DEBUG_LOG_ERROR(format, ...) ((void)0)
+#endif
+
+#if DEBUG_LOG_LEVEL >= DEBUG_LEVEL_WARN
+#define DEBUG_LOG_WARN(format, ...) DEBUG_LOG_SEND("W", format, ##__VA_ARGS__)
+#else
+#define DEBUG_LOG_WARN(format, ...) ((void)0)
+#endif
+
+#if DEBUG_LOG_LEVEL >= DEBUG_LEVEL_INFO
+#define DEBUG_LOG_INFO(format, ...) DEBUG_LOG_SEND("I", format, ##__VA_ARGS__)
+#else
+#define DEBUG_LOG_INFO(format, ...) ((void)0)
+#endif
+
+#if DEBUG_LOG_LEVEL >= DEBUG_LEVEL_DEBUG
+#define DEBUG_LOG_DEBUG(format, ...) DEBUG_LOG_SEND("D", format, ##__VA_ARGS__)
+#else
+#define DEBUG_LOG_DEBUG(format, ...) ((void)0)
+#endif
+
+#endif
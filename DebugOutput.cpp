@@ -0,0 +1,101 @@
+#include <DebugOutput.h>
+
+DebugOutput::DebugOutput()
+{
+	_port = &Serial;
+	_used = 0;
+	_count = 0;
+}
+
+size_t DebugOutput::write(uint8_t data)
+{
+	if(_used == DEBUG_OUTPUT_BUFFER)
+	{
+		flush();
+	}
+	_buffer[_used] = data;
+	_used++;
+	_count++;
+	return 1;
+}
+
+size_t DebugOutput::write(const uint8_t* buffer, size_t size)
+{
+	size_t remaining = size;
+	while(remaining > 0)
+	{
+		if(_used == DEBUG_OUTPUT_BUFFER)
+		{
+			flush();
+		}
+		size_t room = DEBUG_OUTPUT_BUFFER - _used;
+		if(room > remaining)
+		{
+			room = remaining;
+		}
+		memcpy(_buffer + _used, buffer, room);
+		_used += room;
+		buffer += room;
+		remaining -= room;
+	}
+	_count += size;
+	return size;
+}
+
+/**********************************************************
+* @brief Hand everything collected so far to the port.
+*
+*  Must be called before waiting on the user so prompts are shown.
+***********************************************************/
+void DebugOutput::flush()
+{
+	if(_used > 0)
+	{
+		_port->write(_buffer, _used);
+		_used = 0;
+	}
+}
+
+void DebugOutput::setPort(Print &port)
+{
+	_port = &port;
+}
+
+/**********************************************************
+* @brief Write the same character several times (Ex: a row of stars).
+***********************************************************/
+void DebugOutput::repeat(char data, byte count)
+{
+	while(count > 0)
+	{
+		if(_used == DEBUG_OUTPUT_BUFFER)
+		{
+			flush();
+		}
+		byte room = DEBUG_OUTPUT_BUFFER - _used;
+		if(room > count)
+		{
+			room = count;
+		}
+		memset(_buffer + _used, data, room);
+		_used += room;
+		_count += room;
+		count -= room;
+	}
+}
+
+//Bytes written since the last resetCount()
+unsigned long DebugOutput::count()
+{
+	return _count;
+}
+
+void DebugOutput::resetCount()
+{
+	_count = 0;
+}
+
+byte DebugOutput::buffered()
+{
+	return _used;
+}
@@ -0,0 +1,36 @@
+#ifndef _DEBUG_OUTPUT_H_
+#define _DEBUG_OUTPUT_H_
+#include <Arduino.h>
+
+//Bytes collected before they are handed to Serial in one write (a library setting, see ArduinoDebugger.h)
+#ifndef DEBUG_OUTPUT_BUFFER
+#define DEBUG_OUTPUT_BUFFER 32
+#endif
+
+//Collects printed text & protocol frames so the port receives whole chunks
+class DebugOutput : public Print{
+public:
+
+	DebugOutput();
+
+	size_t write(uint8_t data);
+	size_t write(const uint8_t* buffer, size_t size);
+	using Print::write;
+	void flush();
+	//Where flush() sends the collected bytes, Serial unless changed
+	void setPort(Print &port);
+
+	void repeat(char data, byte count);
+	unsigned long count();
+	void resetCount();
+	//Bytes collected but not yet handed to the port
+	byte buffered();
+
+private:
+	Print* _port;
+	byte _buffer[DEBUG_OUTPUT_BUFFER];
+	byte _used;
+	unsigned long _count;
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include <DebugProfile.h>
+
+DebugProfile::DebugProfile()
+{
+	_probes = NULL;
+	_size = 0;
+	_active = false;
+	clear();
+}
+
+/**********************************************************
+* @brief Start counting hits in the sketch's probe table.
+*
+*	@param probes One entry per breakpoint name to profile
+*	@param size The number of entries in probes
+***********************************************************/
+void DebugProfile::begin(Probe probes[], byte size)
+{
+	_probes = probes;
+	_size = size;
+	clear();
+	_active = _size > 0;
+}
+
+void DebugProfile::end()
+{
+	_active = false;
+}
+
+void DebugProfile::clear()
+{
+	_count = 0;
+	_missed = 0;
+}
+
+bool DebugProfile::active()
+{
+	return _active;
+}
+
+/**********************************************************
+* @brief Count a hit & time it against the previous one.
+*
+*  Probes are matched by the label's address, so a string
+*  literal is looked up without comparing any text.  Identical
+*  literals are merged by the compiler and share a probe.
+***********************************************************/
+void DebugProfile::hit(const char* label)
+{
+	unsigned long now = micros();
+	byte i = 0;
+	while(i < _count && _probes[i].label != label)
+	{
+		i++;
+	}
+	if(i == _count)
+	{//First hit of this label
+		if(_count == _size)
+		{
+			_missed++;
+			return;
+		}
+		Probe probe = {label, 1, now, 0xFFFFFFFF, 0, 0};
+		_probes[i] = probe;
+		_count++;
+		return;
+	}
+	Probe &probe = _probes[i];
+	unsigned long interval = now - probe.last;
+	probe.last = now;
+	probe.hits++;
+	probe.total += interval;
+	if(interval < probe.shortest)
+	{
+		probe.shortest = interval;
+	}
+	if(interval > probe.longest)
+	{
+		probe.longest = interval;
+	}
+}
+
+byte DebugProfile::count()
+{
+	return _count;
+}
+
+Probe& DebugProfile::probe(byte index)
+{
+	return _probes[index];
+}
+
+//Mean microseconds between hits, 0 until the second hit
+unsigned long DebugProfile::mean(byte index)
+{
+	Probe &probe = _probes[index];
+	return probe.hits < 2 ? 0 : probe.total / (probe.hits - 1);
+}
+
+unsigned long DebugProfile::missed()
+{
+	return _missed;
+}
@@ -0,0 +1,42 @@
+#ifndef _DEBUG_PROFILE_H_
+#define _DEBUG_PROFILE_H_
+#include <Arduino.h>
+
+//Hits & time between hits of one named breakpoint
+struct Probe
+{
+	const char* label;//The breakpoint's name, probes are found by its address
+	unsigned long hits;
+	unsigned long last;//micros() of the latest hit
+	unsigned long shortest;//Microseconds between hits
+	unsigned long longest;
+	unsigned long total;//Sum of every interval, for the mean
+};
+
+class DebugProfile{
+public:
+
+	DebugProfile();
+
+	void begin(Probe probes[], byte size);
+	void end();
+	void clear();
+	bool active();
+
+	//Record one hit of a named breakpoint
+	void hit(const char* label);
+
+	byte count();
+	Probe& probe(byte index);
+	unsigned long mean(byte index);
+	unsigned long missed();
+
+private:
+	Probe* _probes;
+	byte _size;
+	byte _count;
+	bool _active;
+	unsigned long _missed;//Hits of labels that didn't fit in the table
+};
+
+#endif
@@ -0,0 +1,164 @@
+#include <DebugProtocol.h>
+
+DebugProtocol::DebugProtocol(DebugOutput &out) : _out(out)
+{
+	reset();
+}
+
+DebugProtocol& DebugProtocol::operator=(const DebugProtocol &other)
+{
+	_state = other._state;
+	_length = other._length;
+	_opcode = other._opcode;
+	_received = other._received;
+	_rx_sum = other._rx_sum;
+	_tx_sum = other._tx_sum;
+	memcpy(_payload, other._payload, sizeof(_payload));
+	return *this;
+}
+
+/**********************************************************
+* @brief Add one received byte to the frame being assembled.
+*
+*  The parser never blocks, so it can be driven by however many
+*  bytes happen to be waiting in the Serial buffer.
+*
+*	@param data The next byte read from the Serial port
+*	@return FRAME_READY once a complete frame with a valid checksum
+*					has arrived, FRAME_ERROR if the checksum did not match,
+*					otherwise FRAME_PENDING.
+***********************************************************/
+FrameStatus DebugProtocol::feed(byte data)
+{
+	switch(_state)
+	{
+		case WAIT_SYNC:
+			if(data == DEBUG_FRAME_SYNC)
+			{
+				_state = WAIT_LENGTH;
+			}
+			break;
+
+		case WAIT_LENGTH:
+			if(data > DEBUG_MAX_PAYLOAD)
+			{//Frame can't fit in our buffer, resynchronize
+				_state = WAIT_SYNC;
+				return FRAME_ERROR;
+			}
+			_length = data;
+			_rx_sum = data;
+			_received = 0;
+			_state = WAIT_OPCODE;
+			break;
+
+		case WAIT_OPCODE:
+			_opcode = data;
+			_rx_sum += data;
+			_state = (_length > 0) ? WAIT_PAYLOAD : WAIT_CHECKSUM;
+			break;
+
+		case WAIT_PAYLOAD:
+			_payload[_received] = data;
+			_received++;
+			_rx_sum += data;
+			if(_received == _length)
+			{
+				_state = WAIT_CHECKSUM;
+			}
+			break;
+
+		case WAIT_CHECKSUM:
+			_state = WAIT_SYNC;
+			if((byte)(_rx_sum + data) == 0)
+			{
+				return FRAME_READY;
+			}
+			return FRAME_ERROR;
+	}
+	return FRAME_PENDING;
+}
+
+void DebugProtocol::reset()
+{
+	_state = WAIT_SYNC;
+	_length = 0;
+	_opcode = 0;
+	_received = 0;
+	_rx_sum = 0;
+}
+
+byte DebugProtocol::opcode()
+{
+	return _opcode;
+}
+
+byte DebugProtocol::length()
+{
+	return _length;
+}
+
+byte* DebugProtocol::payload()
+{
+	return _payload;
+}
+
+/**********************************************************
+* @brief Start sending a frame to the host.
+*
+*  The payload is written with writeByte()/writeBytes() and the
+*  frame is completed with endFrame().  Frames are streamed through
+*  the output buffer, so responses may be larger than DEBUG_MAX_PAYLOAD.
+*  The buffer isn't flushed, the caller does that once its answer is
+*  written so sending a frame never waits on the port.
+*
+*	@param opcode The response opcode
+*	@param length The exact number of payload bytes that will follow
+***********************************************************/
+void DebugProtocol::beginFrame(byte opcode, byte length)
+{
+	_out.write(DEBUG_FRAME_SYNC);
+	_out.write(length);
+	_out.write(opcode);
+	_tx_sum = length + opcode;
+}
+
+void DebugProtocol::writeByte(byte data)
+{
+	_out.write(data);
+	_tx_sum += data;
+}
+
+void DebugProtocol::writeBytes(const void* data, byte length)
+{
+	const byte* bytes = (const byte*)data;
+	for(byte i = 0; i < length; i++)
+	{
+		_tx_sum += bytes[i];
+	}
+	_out.write(bytes, length);
+}
+
+void DebugProtocol::endFrame()
+{
+	_out.write((byte)(0 - _tx_sum));
+}
+
+void DebugProtocol::sendFrame(byte opcode, const void* payload, byte length)
+{
+	beginFrame(opcode, length);
+	writeBytes(payload, length);
+	endFrame();
+}
+
+void DebugProtocol::sendAck()
+{
+	beginFrame(OP_ACK, 0);
+	endFrame();
+}
+
+void DebugProtocol::sendNak(byte error)
+{
+	beginFrame(OP_NAK, 1);
+	writeByte(error);
+	endFrame();
+}
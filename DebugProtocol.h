@@ -0,0 +1,110 @@
+#ifndef _DEBUG_PROTOCOL_H_
+#define _DEBUG_PROTOCOL_H_
+#include <Arduino.h>
+#include <DebugOutput.h>
+
+//Every frame on the wire is laid out as:
+//  SYNC | LENGTH | OPCODE | PAYLOAD[LENGTH] | CHECKSUM
+//The checksum is chosen so LENGTH + OPCODE + PAYLOAD + CHECKSUM sums to 0 (mod 256)
+#define DEBUG_FRAME_SYNC 0xA5
+
+//Largest payload accepted from the host (responses are streamed and may use up to 255 bytes) (a library setting, see ArduinoDebugger.h)
+#ifndef DEBUG_MAX_PAYLOAD
+#define DEBUG_MAX_PAYLOAD 32
+#endif
+static_assert(DEBUG_MAX_PAYLOAD <= 255, "A frame's length is one byte");
+
+enum Opcode
+{
+		//Host -> Device
+		OP_LIST_WATCHES = 0x01,
+		OP_READ_VAR = 0x02,
+		OP_WRITE_VAR = 0x03,
+		OP_READ_PINS = 0x04,
+		OP_WRITE_PIN = 0x05,
+		OP_CONTINUE = 0x06,
+		OP_DUMP_TRACE = 0x07,
+		OP_SET_CONDITION = 0x08,
+		OP_READ_PIN_CHANGES = 0x09,
+		OP_READ_PROFILE = 0x0A,
+		OP_READ_CHANGES = 0x0B,
+		OP_READ_TABLE = 0x0C,
+		OP_READ_VALUES = 0x0D,
+		OP_BREAK = 0x0E,
+		//Device -> Host
+		OP_HALT = 0x40,
+		OP_WATCH = 0x41,
+		OP_VALUE = 0x42,
+		OP_PINS = 0x43,
+		OP_TRACE = 0x44,
+		OP_TRACE_DATA = 0x45,
+		OP_PIN_CHANGES = 0x46,
+		OP_PROFILE = 0x47,
+		OP_TABLE = 0x48,
+		OP_VALUES = 0x49,
+		OP_LOG = 0x4A,
+		OP_ACK = 0x7E,
+		OP_NAK = 0x7F
+};
+
+enum ProtocolError
+{
+		ERR_CHECKSUM = 1,
+		ERR_OPCODE,
+		ERR_INDEX,
+		ERR_LENGTH,
+		ERR_VALUE
+};
+
+enum FrameStatus
+{
+		FRAME_PENDING,
+		FRAME_READY,
+		FRAME_ERROR
+};
+
+class DebugProtocol{
+public:
+
+	DebugProtocol(DebugOutput &out);
+	//Copies the parser's state, the output stays the one given to the constructor
+	DebugProtocol& operator=(const DebugProtocol &other);
+
+	//Incoming frames are assembled one byte at a time
+	FrameStatus feed(byte data);
+	void reset();
+
+	byte opcode();
+	byte length();
+	byte* payload();
+
+	//Outgoing frames are streamed through the output buffer
+	void beginFrame(byte opcode, byte length);
+	void writeByte(byte data);
+	void writeBytes(const void* data, byte length);
+	void endFrame();
+	void sendFrame(byte opcode, const void* payload, byte length);
+	void sendAck();
+	void sendNak(byte error);
+
+private:
+	enum ParseState
+	{
+		WAIT_SYNC,
+		WAIT_LENGTH,
+		WAIT_OPCODE,
+		WAIT_PAYLOAD,
+		WAIT_CHECKSUM
+	};
+
+	DebugOutput &_out;
+	ParseState _state;
+	byte _length;
+	byte _opcode;
+	byte _received;
+	byte _rx_sum;
+	byte _tx_sum;
+	byte _payload[DEBUG_MAX_PAYLOAD];
+};
+
+#endif
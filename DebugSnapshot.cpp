@@ -0,0 +1,76 @@
+#include <DebugSnapshot.h>
+
+DebugSnapshot::DebugSnapshot()
+{
+	_sums = NULL;
+	_size = 0;
+	_valid = false;
+}
+
+/**********************************************************
+* @brief Start keeping checksums in the sketch's table.
+*
+*	@param sums One entry per non array variable and per
+*					DEBUG_SNAPSHOT_BLOCK elements of each array
+*	@param size The number of entries in sums
+***********************************************************/
+void DebugSnapshot::begin(uint16_t sums[], unsigned int size)
+{
+	_sums = sums;
+	_size = size;
+	clear();
+}
+
+void DebugSnapshot::end()
+{
+	_sums = NULL;
+	_size = 0;
+}
+
+bool DebugSnapshot::active()
+{
+	return _sums != NULL;
+}
+
+void DebugSnapshot::clear()
+{
+	_valid = false;
+}
+
+//The checksums stored since clear() become the values to compare against
+void DebugSnapshot::baseline()
+{
+	_valid = true;
+}
+
+/**********************************************************
+* @brief Check whether a block of data changed since it was last compared.
+*
+*	@note Blocks past the end of the table can't be compared and always
+*  read as changed.
+*	@param block The block's position in the table
+*	@param data The block's bytes
+*	@param length The number of bytes in the block
+***********************************************************/
+bool DebugSnapshot::changed(unsigned int block, const byte* data, unsigned int length)
+{
+	if(block >= _size)
+	{
+		return true;
+	}
+	uint16_t sum = checksum(data, length);
+	bool changed = !_valid || _sums[block] != sum;
+	_sums[block] = sum;
+	return changed;
+}
+
+//Same hash as the watch names (debugHash()), every byte moves the result
+uint16_t DebugSnapshot::checksum(const byte* data, unsigned int length)
+{
+	uint16_t sum = 5381;
+	for(unsigned int i = 0; i < length; i++)
+	{
+		sum = (sum * 33) ^ data[i];
+	}
+	return sum;
+}
@@ -0,0 +1,34 @@
+#ifndef _DEBUG_SNAPSHOT_H_
+#define _DEBUG_SNAPSHOT_H_
+#include <Arduino.h>
+
+//Array elements covered by one checksum (a library setting, see ArduinoDebugger.h)
+#ifndef DEBUG_SNAPSHOT_BLOCK
+#define DEBUG_SNAPSHOT_BLOCK 8
+#endif
+
+//Checksums of watched data, used to find what changed since it was last shown
+class DebugSnapshot{
+public:
+
+	DebugSnapshot();
+
+	void begin(uint16_t sums[], unsigned int size);
+	void end();
+	bool active();
+
+	//Forget the stored checksums, every block reads as changed until baseline()
+	void clear();
+	void baseline();
+
+	//Compare a block against its checksum & store the new one
+	bool changed(unsigned int block, const byte* data, unsigned int length);
+	static uint16_t checksum(const byte* data, unsigned int length);
+
+private:
+	uint16_t* _sums;
+	unsigned int _size;
+	bool _valid;//The stored checksums describe the values last shown
+};
+
+#endif
@@ -0,0 +1,214 @@
+#include <DebugTrace.h>
+
+DebugTrace::DebugTrace()
+{
+	_channels = NULL;
+	_buffer = NULL;
+	_size = 0;
+	_period = 0;
+	_num_channels = 0;
+	_recording = false;
+	clear();
+}
+
+/**********************************************************
+* @brief Prepare a trace that records into the sketch's buffer.
+*
+*  Channels are added with addChannel() and recording begins
+*  with start().  The channels take the start of the buffer, the
+*  records fill the rest.
+*
+*	@param buffer RAM used as the ring buffer
+*	@param size The size of buffer in bytes
+*	@param period Microseconds between samples taken by trigger(),
+*					0 records on every call
+***********************************************************/
+void DebugTrace::begin(byte buffer[], unsigned int size, unsigned long period)
+{
+	_recording = false;
+	//Line the channels up for their pointers
+	unsigned int skip = (alignof(TraceChannel) - (uintptr_t)buffer % alignof(TraceChannel)) % alignof(TraceChannel);
+	_channels = (buffer == NULL || size < skip) ? NULL : (TraceChannel*)(buffer + skip);
+	_buffer = (byte*)_channels;
+	_size = (_channels == NULL) ? 0 : size - skip;
+	_period = period;
+	_num_channels = 0;
+	_record_size = sizeof(unsigned long);//Every record starts with micros()
+	clear();
+}
+
+bool DebugTrace::addChannel(void* ptr, byte length, byte index)
+{
+	if((_num_channels + 1UL) * sizeof(TraceChannel) > _size)
+	{
+		return false;
+	}
+	TraceChannel channel = {ptr, length, index};
+	_channels[_num_channels] = channel;
+	_num_channels++;
+	_buffer = (byte*)(_channels + _num_channels);
+	_record_size += length;
+	return true;
+}
+
+void DebugTrace::moveChannels(byte index, void* ptr)
+{
+	for(byte i = 0; i < _num_channels; i++)
+	{
+		if(_channels[i].index == index)
+		{
+			_channels[i].ptr = ptr;
+		}
+	}
+}
+
+//The record keeps its layout, the channel is no longer tied to a watch (its slot may be reused)
+void DebugTrace::dropChannels(byte index)
+{
+	for(byte i = 0; i < _num_channels; i++)
+	{
+		if(_channels[i].index == index)
+		{
+			_channels[i].ptr = NULL;
+			_channels[i].index = 255;
+		}
+	}
+}
+
+/**********************************************************
+* @brief Start recording.
+*
+*	@return false if not even one record fits in the buffer
+***********************************************************/
+bool DebugTrace::start()
+{
+	_capacity = (_channels == NULL) ? 0 : (_size - _num_channels * sizeof(TraceChannel)) / _record_size;
+	clear();
+	_recording = _capacity > 0;
+	return _recording;
+}
+
+void DebugTrace::stop()
+{
+	_recording = false;
+}
+
+void DebugTrace::clear()
+{
+	_head = 0;
+	_count = 0;
+	_last = micros();
+}
+
+/**********************************************************
+* @brief Record a sample once the sampling period has passed.
+*
+*  Place this at the point in the program that should be traced.
+***********************************************************/
+void DebugTrace::trigger()
+{
+	if(!_recording)
+	{
+		return;
+	}
+	if(_period != 0)
+	{
+		unsigned long now = micros();
+		if(now - _last < _period)
+		{
+			return;
+		}
+		_last = now;
+	}
+	sample();
+}
+
+/**********************************************************
+* @brief Copy every channel into the next record of the ring.
+*
+*  The oldest record is overwritten once the buffer is full.
+***********************************************************/
+void DebugTrace::sample()
+{
+	byte* record = _buffer + _head * _record_size;
+	unsigned long now = micros();
+	memcpy(record, &now, sizeof(now));
+	record += sizeof(now);
+	for(byte i = 0; i < _num_channels; i++)
+	{
+		if(_channels[i].ptr == NULL)
+		{
+			memset(record, 0, _channels[i].length);
+		}
+		else
+		{
+			memcpy(record, _channels[i].ptr, _channels[i].length);
+		}
+		record += _channels[i].length;
+	}
+	_head++;
+	if(_head == _capacity)
+	{
+		_head = 0;
+	}
+	if(_count < _capacity)
+	{
+		_count++;
+	}
+}
+
+bool DebugTrace::recording()
+{
+	return _recording;
+}
+
+unsigned int DebugTrace::count()
+{
+	return _count;
+}
+
+unsigned int DebugTrace::recordSize()
+{
+	return _record_size;
+}
+
+byte DebugTrace::channels()
+{
+	return _num_channels;
+}
+
+byte DebugTrace::channelIndex(byte channel)
+{
+	return _channels[channel].index;
+}
+
+/**********************************************************
+* @brief Locate recorded bytes in chronological order.
+*
+*  The ring may wrap, so the recorded bytes are returned as
+*  contiguous runs.
+*
+*	@param offset Bytes from the start of the oldest record
+*	@param length Set to the number of contiguous bytes available
+*	@return Pointer to the byte at offset
+***********************************************************/
+const byte* DebugTrace::data(unsigned long offset, unsigned int &length)
+{
+	unsigned int oldest = (_count < _capacity) ? 0 : _head;
+	unsigned long used = (unsigned long)_capacity * _record_size;
+	unsigned long position = (unsigned long)oldest * _record_size + offset;
+	if(position >= used)
+	{//Wrapped around to the start of the buffer
+		position -= used;
+		length = (unsigned long)_head * _record_size - position;
+	}
+	else
+	{
+		length = used - position;
+		if(oldest == 0)
+		{//Nothing was overwritten, stop at the newest record
+			length = (unsigned long)_count * _record_size - position;
+		}
+	}
+	return _buffer + position;
+}
@@ -0,0 +1,52 @@
+#ifndef _DEBUG_TRACE_H_
+#define _DEBUG_TRACE_H_
+#include <Arduino.h>
+
+//Kept at the start of the sketch's buffer, ahead of the records
+struct TraceChannel
+{
+	void* ptr;//NULL once the watch is gone, its bytes are then recorded as 0
+	byte length;
+	byte index;//Position of the variable in the watch list, 255 once it is gone
+};
+
+class DebugTrace{
+public:
+
+	DebugTrace();
+
+	void begin(byte buffer[], unsigned int size, unsigned long period);
+	bool addChannel(void* ptr, byte length, byte index);
+	//Follow a watch pointed at a new copy of its variable, or stop reading one that's gone
+	void moveChannels(byte index, void* ptr);
+	void dropChannels(byte index);
+	bool start();
+	void stop();
+	void clear();
+
+	//Record a sample if the sampling period has passed
+	void trigger();
+	void sample();
+
+	bool recording();
+	unsigned int count();
+	unsigned int recordSize();
+	byte channels();
+	byte channelIndex(byte channel);
+	const byte* data(unsigned long offset, unsigned int &length);
+
+private:
+	TraceChannel* _channels;
+	byte* _buffer;//First record, just past the channels
+	unsigned int _size;//Bytes from _channels to the end of the sketch's buffer
+	unsigned int _record_size;
+	unsigned int _capacity;
+	unsigned int _head;
+	unsigned int _count;
+	unsigned long _period;
+	unsigned long _last;
+	bool _recording;
+	byte _num_channels;
+};
+
+#endif
@@ -2,16 +2,14 @@
 #include <ArduinoDebuggerF.h>
 #include <Debugger.h>
 
-static ArduinoDebugger Debugger::initialize(bool usingFloat, bool isAvr, bool usingTerminal)
+ArduinoDebugger Debugger::initialize(bool usingFloat, bool isAvr, bool usingTerminal, bool usingProtocol)
 {
 	if(usingFloat)
-	{
-		ArduinoDebuggerF debug(isAvr, usingTerminal);
-		return debug;
+	{//The ArduinoDebugger it is moved into keeps ArduinoDebuggerF's float support
+		return ArduinoDebuggerF(isAvr, usingTerminal, usingProtocol);
 	}
 	else
 	{
-		ArduinoDebugger debug(isAvr, usingTerminal);
-		return debug;
+		return ArduinoDebugger(isAvr, usingTerminal, usingProtocol);
 	}
 }
\ No newline at end of file
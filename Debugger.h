@@ -6,7 +6,7 @@
 class Debugger{
 public:
 
-	static ArduinoDebugger initialize(bool usingFloat, bool isAvr, bool usingTerminal);
+	static ArduinoDebugger initialize(bool usingFloat, bool isAvr, bool usingTerminal, bool usingProtocol = false);
 
 };
 #endif
\ No newline at end of file
@@ -1,4 +1,4 @@
-#include <ArduinoDebugger.h>
+#include <ArduinoDebuggerF.h>
 //Code is a modified version from Adafruit's Temperature tutorial
 //https://learn.adafruit.com/tmp36-temperature-sensor/using-a-temp-sensor
 int sensorPin = A0;
@@ -10,17 +10,18 @@ int normalLed = 4;
 int hotLed = 5;
 int coldLed = 6;
 
-ArduinoDebugger debugger(true);//true - 8 Bit AVR, false - 32 bit chip
+Variable watches[4];//Room for the variables added in setup()
+ArduinoDebuggerF debugger(watches, true, false);//true - 8 Bit AVR, false - 32 bit chip
 void setup() {
   Serial.begin(9600);
   while(!Serial){}//Wait until Serial is ready
 	pinMode(normalLed, OUTPUT);
 	pinMode(hotLed, OUTPUT);
 	pinMode(coldLed, OUTPUT);
-	debugger.addWatch(&sensorReading, INT, "sensorReading");
-	debugger.addWatch(&voltage, FLOAT, "voltage");
-	debugger.addWatch(&tempC, FLOAT, "temp_C");
-	debugger.addWatch(&tempF, FLOAT, "temp_F");
+	debugger.add(sensorReading, F("sensorReading"));
+	debugger.add(voltage, F("voltage"));
+	debugger.add(tempC, F("temp_C"));
+	debugger.add(tempF, F("temp_F"));
 }
 
 void loop() {
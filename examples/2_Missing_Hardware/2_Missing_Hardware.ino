@@ -6,12 +6,13 @@ int led_position = 0;//Current LED on
 int led_brightness = 0;//Current brightness level
 int leds[] = {3, 5, 6, 9};//Pins for LEDs (must be PWM)
 int leds_length = 4;//Number of leds
-ArduinoDebugger debugger(true);//true - 8 Bit AVR, false - 32 bit chip
+Variable watches[2];//Room for the variables added in setup()
+ArduinoDebugger debugger(watches, true, false);//true - 8 Bit AVR, false - 32 bit chip
 void setup() {
   Serial.begin(9600);
   while(!Serial){}//Wait until Serial is ready
-	debugger.addWatch(&led_position, INT, "led_position");
-	debugger.addWatch(&led_brightness, INT, "led_brightness");
+	debugger.add(led_position, F("led_position"));
+	debugger.add(led_brightness, F("led_brightness"));
 	//Set each LED as output
 	for(int i = 0; i < leds_length; i++)
 	{
@@ -0,0 +1,85 @@
+#ifndef _BENCH_H_
+#define _BENCH_H_
+//Shared helpers for the benchmark suite.  Every result is printed as one
+//JSON object per line so runs can be diffed or loaded by a script.
+#include <Arduino.h>
+#include <chrono>
+#include <stdio.h>
+#include <vector>
+
+//Times each operation is repeated, the averages are reported
+#ifndef BENCH_RUNS
+#define BENCH_RUNS 200
+#endif
+
+struct BenchResult
+{
+	double ns;//Host time per operation
+	double bytes;//Bytes sent per operation
+	double writes;//Serial writes per operation
+	double digital_reads;
+	double analog_reads;
+};
+
+template <typename Operation>
+BenchResult measure(Operation operation, int runs = BENCH_RUNS)
+{
+	mock_reset();
+	std::chrono::steady_clock::duration elapsed(0);
+	for(int i = 0; i < runs; i++)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		operation();
+		elapsed += std::chrono::steady_clock::now() - start;
+	}
+	BenchResult result;
+	result.ns = std::chrono::duration<double, std::nano>(elapsed).count() / runs;
+	result.bytes = Serial.output().size() / (double)runs;
+	result.writes = Serial.writeCalls() / (double)runs;
+	result.digital_reads = mock_digital_reads / (double)runs;
+	result.analog_reads = mock_analog_reads / (double)runs;
+	return result;
+}
+
+//watches/length are left out of the line when negative
+inline void report(const char* bench, const char* debugger, int watches, int length, const BenchResult &result)
+{
+	printf("{\"bench\":\"%s\",\"debugger\":\"%s\"", bench, debugger);
+	if(watches >= 0)
+	{
+		printf(",\"watches\":%d", watches);
+	}
+	if(length >= 0)
+	{
+		printf(",\"length\":%d", length);
+	}
+	printf(",\"ns\":%.1f,\"bytes\":%.1f,\"writes\":%.1f,\"digital_reads\":%.1f,\"analog_reads\":%.1f}\n",
+		result.ns, result.bytes, result.writes, result.digital_reads, result.analog_reads);
+}
+
+inline void reportSize(const char* name, unsigned long bytes)
+{
+	printf("{\"bench\":\"sizeof\",\"type\":\"%s\",\"bytes\":%lu}\n", name, bytes);
+}
+
+//Queue a command frame for the debugger
+inline void sendFrame(byte opcode, std::vector<byte> payload = std::vector<byte>())
+{
+	std::vector<byte> bytes;
+	bytes.push_back(0xA5);
+	bytes.push_back(payload.size());
+	bytes.push_back(opcode);
+	byte sum = payload.size() + opcode;
+	for(size_t i = 0; i < payload.size(); i++)
+	{
+		bytes.push_back(payload[i]);
+		sum += payload[i];
+	}
+	bytes.push_back(-sum);
+	Serial.feed(bytes.data(), bytes.size());
+}
+
+void benchSessions();
+void benchSweeps();
+
+#endif
@@ -0,0 +1,36 @@
+//Benchmark suite for the host build, prints one JSON object per line.
+//  debugger_bench [sessions|sweeps|sizeof]   (everything by default)
+//Times are host nanoseconds, byte & call counts match the board.
+#include "Bench.h"
+#include <ArduinoDebugger.h>
+#include <ArduinoDebuggerF.h>
+#include <string.h>
+
+static void benchSizes()
+{
+	reportSize("ArduinoDebugger", sizeof(ArduinoDebugger));
+	reportSize("ArduinoDebuggerF", sizeof(ArduinoDebuggerF));
+	reportSize("Variable", sizeof(Variable));
+	reportSize("DebugOutput", sizeof(DebugOutput));
+	reportSize("DebugProtocol", sizeof(DebugProtocol));
+	reportSize("DebugTrace", sizeof(DebugTrace));
+	reportSize("PinSnapshot", sizeof(PinSnapshot));
+}
+
+int main(int argc, char* argv[])
+{
+	const char* only = argc > 1 ? argv[1] : "";
+	if(*only == 0 || strcmp(only, "sizeof") == 0)
+	{
+		benchSizes();
+	}
+	if(*only == 0 || strcmp(only, "sessions") == 0)
+	{
+		benchSessions();
+	}
+	if(*only == 0 || strcmp(only, "sweeps") == 0)
+	{
+		benchSweeps();
+	}
+	return 0;
+}
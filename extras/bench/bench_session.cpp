@@ -0,0 +1,127 @@
+//Scripted breakpoint sessions: the cost of each menu & protocol operation
+#include "Bench.h"
+#include <ArduinoDebugger.h>
+#include <ArduinoDebuggerF.h>
+
+struct Watches
+{
+	int count = 5;
+	long total = 100000;
+	bool ready = true;
+	char grade = 'A';
+	byte levels[16] = {0};
+	int samples[64] = {0};
+	float temperature = 21.5;
+};
+
+static void addWatches(ArduinoDebugger &debugger, Watches &w)
+{
+	debugger.add(w.count, "count");
+	debugger.add(w.total, "total");
+	debugger.add(w.ready, "ready");
+	debugger.add(w.grade, "grade");
+	debugger.add(w.levels, "levels");
+	debugger.add(w.samples, "samples");
+	debugger.add(w.temperature, "temperature");
+}
+
+template <typename Debugger>
+static void benchSession(const char* name, Debugger &text, Debugger &protocol)
+{
+	report("menu_continue", name, 7, -1, measure([&]() {
+		Serial.feed("q\n");
+		text.breakpoint("bench");
+	}));
+	report("menu_view_variables", name, 7, -1, measure([&]() {
+		Serial.feed("2\nq\nq\n");
+		text.breakpoint("bench");
+	}));
+	report("menu_update_int", name, 7, -1, measure([&]() {
+		Serial.feed("2\n0\n42\nq\nq\n");
+		text.breakpoint("bench");
+	}));
+	report("menu_update_array_element", name, 7, 64, measure([&]() {
+		Serial.feed("2\n5\n10\n7\nq\nq\nq\n");
+		text.breakpoint("bench");
+	}));
+	report("menu_update_array_bulk_16", name, 7, 64, measure([&]() {
+		Serial.feed("2\n5\nb\n0\n1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16\nq\nq\nq\n");
+		text.breakpoint("bench");
+	}));
+	report("menu_view_pins", name, -1, -1, measure([&]() {
+		Serial.feed("1\nq\nq\n");
+		text.breakpoint("bench");
+	}));
+	report("displayVariables", name, 7, -1, measure([&]() {
+		text.displayVariables();
+	}));
+	report("displayPins", name, -1, -1, measure([&]() {
+		text.displayPins();
+	}));
+	report("protocol_continue", name, -1, -1, measure([&]() {
+		sendFrame(OP_CONTINUE);
+		protocol.breakpoint("bench");
+	}));
+	report("protocol_list_watches", name, 7, -1, measure([&]() {
+		sendFrame(OP_LIST_WATCHES);
+		sendFrame(OP_CONTINUE);
+		protocol.breakpoint("bench");
+	}));
+	report("protocol_read_array", name, -1, 64, measure([&]() {
+		sendFrame(OP_READ_VAR, std::vector<byte>(1, 5));
+		sendFrame(OP_CONTINUE);
+		protocol.breakpoint("bench");
+	}));
+	report("protocol_read_values", name, 4, -1, measure([&]() {
+		sendFrame(OP_READ_VALUES, std::vector<byte>({0, 1, 2, 3}));
+		sendFrame(OP_CONTINUE);
+		protocol.breakpoint("bench");
+	}));
+	report("protocol_read_pins", name, -1, -1, measure([&]() {
+		sendFrame(OP_READ_PINS);
+		sendFrame(OP_CONTINUE);
+		protocol.breakpoint("bench");
+	}));
+	report("poll_idle", name, -1, -1, measure([&]() {
+		protocol.poll();
+	}));
+	report("checkpoint_idle", name, -1, -1, measure([&]() {
+		text.checkpoint();
+	}));
+	Probe probes[4];
+	text.profileBegin(probes);
+	report("profile_hit", name, -1, -1, measure([&]() {
+		text.breakpoint("bench");
+	}));
+	text.profileEnd();
+	text.watchpoint(0);//count
+	text.watchpoint(5);//samples[64]
+	text.watchpointIf("total > 200000");
+	report("check_unchanged", name, 7, -1, measure([&]() {
+		text.check();
+	}));
+	text.clearWatchpoints();
+	uint16_t sums[16];
+	text.snapshotBegin(sums);
+	text.displayChanges();
+	report("displayChanges_unchanged", name, 7, -1, measure([&]() {
+		text.displayChanges();
+	}));
+	text.snapshotEnd();
+}
+
+void benchSessions()
+{
+	Watches w;
+	ArduinoDebugger text(true, true);
+	ArduinoDebugger protocol(true, true, true);
+	addWatches(text, w);
+	addWatches(protocol, w);
+	benchSession("ArduinoDebugger", text, protocol);
+
+	ArduinoDebuggerF text_f(true, true);
+	ArduinoDebuggerF protocol_f(true, true, true);
+	addWatches(text_f, w);
+	addWatches(protocol_f, w);
+	benchSession("ArduinoDebuggerF", text_f, protocol_f);
+}
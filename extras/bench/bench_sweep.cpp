@@ -0,0 +1,87 @@
+//How the cost of each screen grows with the number of watches & array length
+#include "Bench.h"
+#include <ArduinoDebugger.h>
+#include <ArduinoDebuggerF.h>
+
+//Most watches added in the watch count sweep
+#ifndef BENCH_MAX_WATCHES
+#define BENCH_MAX_WATCHES 10
+#endif
+
+static const int array_lengths[] = {1, 16, 64, 256, 1024};
+
+template <typename Debugger>
+static void sweepWatches(const char* name)
+{
+	static int values[BENCH_MAX_WATCHES];
+	static char names[BENCH_MAX_WATCHES][8];
+	for(int watches = 1; watches <= BENCH_MAX_WATCHES; watches++)
+	{
+		Debugger text(true, true);
+		Debugger protocol(true, true, true);
+		for(int i = 0; i < watches; i++)
+		{
+			snprintf(names[i], sizeof(names[i]), "value%d", i);
+			text.add(values[i], names[i]);
+			protocol.add(values[i], names[i]);
+		}
+		report("sweep_displayVariables", name, watches, -1, measure([&]() {
+			text.displayVariables();
+		}));
+		report("sweep_menu_update_int", name, watches, -1, measure([&]() {
+			Serial.feed("2\n0\n1\nq\nq\n");
+			text.breakpoint("bench");
+		}));
+		report("sweep_protocol_list_watches", name, watches, -1, measure([&]() {
+			sendFrame(OP_LIST_WATCHES);
+			sendFrame(OP_CONTINUE);
+			protocol.breakpoint("bench");
+		}));
+		//Adding every pass through loop(), the last watch is the slowest to find
+		int last = watches - 1;
+		report("sweep_readd_name", name, watches, -1, measure([&]() {
+			text.add(values[last], names[last]);
+		}));
+		report("sweep_update_by_id", name, watches, -1, measure([&]() {
+			text.updateWatch(last, values[last]);
+		}));
+	}
+}
+
+template <typename Debugger>
+static void sweepArrays(const char* name)
+{
+	static int values[1024];
+	for(size_t i = 0; i < sizeof(array_lengths) / sizeof(array_lengths[0]); i++)
+	{
+		int length = array_lengths[i];
+		Debugger text(true, true);
+		Debugger protocol(true, true, true);
+		//The legacy add() takes the length from the name, so any prefix of values can be watched
+		static char array_name[16];
+		snprintf(array_name, sizeof(array_name), "values_%d", length);
+		text.add(values, Type::INT_ARRAY, array_name);
+		protocol.add(values, Type::INT_ARRAY, array_name);
+		int runs = length >= 256 ? BENCH_RUNS / 10 : BENCH_RUNS;
+		report("sweep_displayVariables_array", name, 1, length, measure([&]() {
+			text.displayVariables();
+		}, runs));
+		report("sweep_updateArray", name, 1, length, measure([&]() {
+			Serial.feed("2\n0\n0\n3\nq\nq\nq\n");
+			text.breakpoint("bench");
+		}, runs));
+		report("sweep_protocol_read_array", name, 1, length, measure([&]() {
+			sendFrame(OP_READ_VAR, std::vector<byte>(1, 0));
+			sendFrame(OP_CONTINUE);
+			protocol.breakpoint("bench");
+		}, runs));
+	}
+}
+
+void benchSweeps()
+{
+	sweepWatches<ArduinoDebugger>("ArduinoDebugger");
+	sweepWatches<ArduinoDebuggerF>("ArduinoDebuggerF");
+	sweepArrays<ArduinoDebugger>("ArduinoDebugger");
+	sweepArrays<ArduinoDebuggerF>("ArduinoDebuggerF");
+}
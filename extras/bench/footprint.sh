@@ -0,0 +1,33 @@
+#!/bin/sh
+# Flash & RAM footprint of ArduinoDebugger vs ArduinoDebuggerF, one JSON object per line.
+# With arduino-cli the examples are compiled for an Uno (FQBN overrides the board):
+#   1_Check_Variables uses ArduinoDebuggerF, 2_Missing_Hardware uses ArduinoDebugger.
+# Without it the host objects in the static library given as $1 are measured instead,
+# which only shows how the sizes move between commits.
+if command -v arduino-cli >/dev/null 2>&1; then
+	for example in 1_Check_Variables:ArduinoDebuggerF 2_Missing_Hardware:ArduinoDebugger; do
+		sketch=${example%%:*}
+		class=${example##*:}
+		arduino-cli compile --fqbn "${FQBN:-arduino:avr:uno}" --library . "examples/$sketch" 2>&1 |
+			awk -v class="$class" '
+				/Sketch uses/ { flash = $3 }
+				/Global variables use/ { ram = $4 }
+				END { printf "{\"bench\":\"footprint\",\"debugger\":\"%s\",\"target\":\"avr\",\"flash\":%d,\"ram\":%d}\n", class, flash, ram }'
+	done
+else
+	size "$1" | awk '
+		NR > 1 {
+			name = $6
+			sub(/.*\//, "", name)
+			sub(/\.cpp\.o.*/, "", name)
+			printf "{\"bench\":\"footprint\",\"object\":\"%s\",\"target\":\"host\",\"flash\":%d,\"ram\":%d}\n", name, $1 + $2, $2 + $3
+			if (name != "Debugger") {
+				flash_f += $1 + $2; ram_f += $2 + $3
+				if (name != "ArduinoDebuggerF") { flash += $1 + $2; ram += $2 + $3 }
+			}
+		}
+		END {
+			printf "{\"bench\":\"footprint\",\"debugger\":\"ArduinoDebugger\",\"target\":\"host\",\"flash\":%d,\"ram\":%d}\n", flash, ram
+			printf "{\"bench\":\"footprint\",\"debugger\":\"ArduinoDebuggerF\",\"target\":\"host\",\"flash\":%d,\"ram\":%d}\n", flash_f, ram_f
+		}'
+fi
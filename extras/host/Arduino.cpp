@@ -0,0 +1,370 @@
+#include <Arduino.h>
+
+volatile uint32_t mock_port_output[3];
+volatile uint32_t mock_port_input[3];
+static uint8_t mock_external[3];//Levels applied to pins from outside
+static uint8_t mock_direction[3];
+static int mock_analog[NUM_ANALOG_INPUTS];
+volatile unsigned long mock_clock;
+static unsigned long mock_tick = 1;
+unsigned long mock_digital_reads;
+unsigned long mock_analog_reads;
+
+HardwareSerial Serial;
+HardwareSerial Serial1;
+
+//Polls of an empty Serial before a script is considered finished
+#define MOCK_IDLE_POLLS 2000000UL
+
+//An output pin reads back what it drives, an input reads the outside level
+static void mock_updateInput(uint8_t port)
+{
+	mock_port_input[port] = (mock_port_output[port] & mock_direction[port]) |
+		(mock_external[port] & ~mock_direction[port]);
+}
+
+void mock_reset()
+{
+	for(uint8_t port = 0; port < 3; port++)
+	{
+		mock_port_output[port] = 0;
+		mock_external[port] = 0;
+		mock_direction[port] = 0;
+		mock_updateInput(port);
+	}
+	for(uint8_t pin = 0; pin < NUM_ANALOG_INPUTS; pin++)
+	{
+		mock_analog[pin] = 0;
+	}
+	mock_clock = 0;
+	mock_tick = 1;
+	mock_digital_reads = 0;
+	mock_analog_reads = 0;
+	Serial.clear();
+	Serial1.clear();
+}
+
+void mock_setInput(uint8_t pin, uint8_t val)
+{
+	uint8_t port = digitalPinToPort(pin);
+	if(val)
+	{
+		mock_external[port] |= digitalPinToBitMask(pin);
+	}
+	else
+	{
+		mock_external[port] &= ~digitalPinToBitMask(pin);
+	}
+	mock_updateInput(port);
+}
+
+void mock_setAnalog(uint8_t pin, int value)
+{
+	if(pin >= A0)
+	{
+		pin -= A0;
+	}
+	if(pin < NUM_ANALOG_INPUTS)
+	{
+		mock_analog[pin] = value;
+	}
+}
+
+void mock_advance(unsigned long us)
+{
+	mock_clock += us;
+}
+
+void mock_setTick(unsigned long us)
+{
+	mock_tick = us;
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+	uint8_t port = digitalPinToPort(pin);
+	if(mode == OUTPUT)
+	{
+		mock_direction[port] |= digitalPinToBitMask(pin);
+	}
+	else
+	{
+		mock_direction[port] &= ~digitalPinToBitMask(pin);
+		if(mode == INPUT_PULLUP)
+		{
+			mock_port_output[port] |= digitalPinToBitMask(pin);
+		}
+	}
+	mock_updateInput(port);
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+	uint8_t port = digitalPinToPort(pin);
+	if(val)
+	{
+		mock_port_output[port] |= digitalPinToBitMask(pin);
+	}
+	else
+	{
+		mock_port_output[port] &= ~digitalPinToBitMask(pin);
+	}
+	mock_updateInput(port);
+}
+
+int digitalRead(uint8_t pin)
+{
+	mock_digital_reads++;
+	return (mock_port_input[digitalPinToPort(pin)] & digitalPinToBitMask(pin)) ? HIGH : LOW;
+}
+
+int analogRead(uint8_t pin)
+{
+	mock_analog_reads++;
+	if(pin >= A0)
+	{
+		pin -= A0;
+	}
+	return pin < NUM_ANALOG_INPUTS ? mock_analog[pin] : 0;
+}
+
+void analogWrite(uint8_t pin, int val)
+{
+	pinMode(pin, OUTPUT);
+	digitalWrite(pin, val >= 128 ? HIGH : LOW);
+}
+
+//The clock moves on a little every time it is read so that busy-wait loops end
+unsigned long micros()
+{
+	mock_clock += mock_tick;
+	return mock_clock;
+}
+
+unsigned long millis()
+{
+	return micros() / 1000;
+}
+
+void delay(unsigned long ms)
+{
+	mock_clock += ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+	mock_clock += us;
+}
+
+/******************** Print ********************/
+
+size_t Print::write(const uint8_t* buffer, size_t size)
+{
+	size_t n = 0;
+	while(size--)
+	{
+		n += write(*buffer++);
+	}
+	return n;
+}
+
+size_t Print::printNumber(unsigned long n, uint8_t base)
+{
+	char buf[8 * sizeof(long) + 1];
+	char* str = &buf[sizeof(buf) - 1];
+	*str = '\0';
+	if(base < 2)
+	{
+		base = 10;
+	}
+	do
+	{
+		char c = n % base;
+		n /= base;
+		*--str = c < 10 ? c + '0' : c + 'A' - 10;
+	} while(n);
+	return write(str);
+}
+
+size_t Print::print(const __FlashStringHelper* str)
+{
+	return write(reinterpret_cast<const char*>(str));
+}
+
+size_t Print::print(const char str[])
+{
+	return write(str);
+}
+
+size_t Print::print(char c)
+{
+	return write((uint8_t)c);
+}
+
+size_t Print::print(unsigned char n, int base)
+{
+	return print((unsigned long)n, base);
+}
+
+size_t Print::print(int n, int base)
+{
+	return print((long)n, base);
+}
+
+size_t Print::print(unsigned int n, int base)
+{
+	return print((unsigned long)n, base);
+}
+
+size_t Print::print(long n, int base)
+{
+	if(base == 10 && n < 0)
+	{
+		size_t t = print('-');
+		return t + printNumber(-(unsigned long)n, 10);
+	}
+	return printNumber(n, base);
+}
+
+size_t Print::print(unsigned long n, int base)
+{
+	return printNumber(n, base);
+}
+
+//Same output as the Arduino core: fixed point, 'digits' decimals, "nan"/"inf"/"ovf"
+size_t Print::print(double number, int digits)
+{
+	if(isnan(number)) return print("nan");
+	if(isinf(number)) return print("inf");
+	if(number > 4294967040.0) return print("ovf");
+	if(number < -4294967040.0) return print("ovf");
+
+	size_t n = 0;
+	if(number < 0.0)
+	{
+		n += print('-');
+		number = -number;
+	}
+	double rounding = 0.5;
+	for(uint8_t i = 0; i < digits; ++i)
+	{
+		rounding /= 10.0;
+	}
+	number += rounding;
+
+	unsigned long int_part = (unsigned long)number;
+	double remainder = number - (double)int_part;
+	n += print(int_part);
+	if(digits > 0)
+	{
+		n += print('.');
+	}
+	while(digits-- > 0)
+	{
+		remainder *= 10.0;
+		unsigned int to_print = (unsigned int)remainder;
+		n += print(to_print);
+		remainder -= to_print;
+	}
+	return n;
+}
+
+size_t Print::println()
+{
+	return write("\r\n");
+}
+
+size_t Print::println(const __FlashStringHelper* str) { size_t n = print(str); return n + println(); }
+size_t Print::println(const char str[]) { size_t n = print(str); return n + println(); }
+size_t Print::println(char c) { size_t n = print(c); return n + println(); }
+size_t Print::println(unsigned char n, int base) { size_t t = print(n, base); return t + println(); }
+size_t Print::println(int n, int base) { size_t t = print(n, base); return t + println(); }
+size_t Print::println(unsigned int n, int base) { size_t t = print(n, base); return t + println(); }
+size_t Print::println(long n, int base) { size_t t = print(n, base); return t + println(); }
+size_t Print::println(unsigned long n, int base) { size_t t = print(n, base); return t + println(); }
+size_t Print::println(double n, int digits) { size_t t = print(n, digits); return t + println(); }
+
+/******************** Stream ********************/
+
+size_t Stream::readBytes(char* buffer, size_t length)
+{
+	size_t count = 0;
+	unsigned long start = millis();
+	while(count < length && millis() - start < _timeout)
+	{
+		int c = read();
+		if(c >= 0)
+		{
+			buffer[count++] = (char)c;
+			start = millis();
+		}
+	}
+	return count;
+}
+
+/******************** HardwareSerial ********************/
+
+int HardwareSerial::available()
+{
+	if(_input.empty())
+	{
+		_idle_polls++;
+		if(_idle_polls > MOCK_IDLE_POLLS)
+		{
+			_idle_polls = 0;
+			throw MockInputExhausted();
+		}
+		return 0;
+	}
+	_idle_polls = 0;
+	return _input.size();
+}
+
+int HardwareSerial::read()
+{
+	if(_input.empty())
+	{
+		return -1;
+	}
+	int c = _input.front();
+	_input.pop_front();
+	return c;
+}
+
+int HardwareSerial::peek()
+{
+	return _input.empty() ? -1 : _input.front();
+}
+
+size_t HardwareSerial::write(uint8_t data)
+{
+	_write_calls++;
+	_output += (char)data;
+	return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size)
+{
+	_write_calls++;
+	_output.append((const char*)buffer, size);
+	return size;
+}
+
+void HardwareSerial::feed(const char* text)
+{
+	feed((const uint8_t*)text, strlen(text));
+}
+
+void HardwareSerial::feed(const uint8_t* data, size_t length)
+{
+	_input.insert(_input.end(), data, data + length);
+}
+
+void HardwareSerial::clear()
+{
+	_input.clear();
+	_output.clear();
+	_write_calls = 0;
+	_idle_polls = 0;
+	_write_room = 64;
+}
@@ -0,0 +1,168 @@
+#ifndef _HOST_ARDUINO_H_
+#define _HOST_ARDUINO_H_
+//Stand-in for the Arduino core so the library can be built & tested on a PC.
+//The pin layout mimics an Arduino Uno: pins 0-7 are PORTD, 8-13 PORTB and
+//14-19 (A0-A5) PORTC, each backed by a fake output & input register.  The
+//registers are 32 bits wide as on SAMD, the AVR path reads their low byte.
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <deque>
+#include <string>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define NUM_DIGITAL_PINS 20
+#define NUM_ANALOG_INPUTS 6
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+
+//Flash strings live in ordinary memory on a PC
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define memcpy_P memcpy
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper*>(string_literal))
+
+//Fake port registers
+extern volatile uint32_t mock_port_output[3];
+extern volatile uint32_t mock_port_input[3];
+#define digitalPinToPort(P) ((P) < 8 ? 0 : (P) < 14 ? 1 : 2)
+#define digitalPinToBitMask(P) ((uint8_t)(1 << ((P) < 8 ? (P) : (P) < 14 ? (P) - 8 : (P) - 14)))
+#define portOutputRegister(port) (&mock_port_output[port])
+#define portInputRegister(port) (&mock_port_input[port])
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+//Test controls
+void mock_reset();
+void mock_setInput(uint8_t pin, uint8_t val);//Level seen on a pin that isn't driven
+void mock_setAnalog(uint8_t pin, int value);
+void mock_advance(unsigned long us);
+void mock_setTick(unsigned long us);//Time added by every millis()/micros() call
+extern volatile unsigned long mock_clock;//Microseconds behind micros() & millis()
+extern unsigned long mock_digital_reads;
+extern unsigned long mock_analog_reads;
+
+class Print
+{
+public:
+	virtual ~Print() {}
+	virtual size_t write(uint8_t) = 0;
+	virtual size_t write(const uint8_t* buffer, size_t size);
+	size_t write(const char* str) { return str == NULL ? 0 : write((const uint8_t*)str, strlen(str)); }
+	size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+	virtual int availableForWrite() { return 0; }
+	virtual void flush() {}
+
+	size_t print(const __FlashStringHelper* str);
+	size_t print(const char str[]);
+	size_t print(char c);
+	size_t print(unsigned char n, int base = 10);
+	size_t print(int n, int base = 10);
+	size_t print(unsigned int n, int base = 10);
+	size_t print(long n, int base = 10);
+	size_t print(unsigned long n, int base = 10);
+	size_t print(double n, int digits = 2);
+
+	size_t println(const __FlashStringHelper* str);
+	size_t println(const char str[]);
+	size_t println(char c);
+	size_t println(unsigned char n, int base = 10);
+	size_t println(int n, int base = 10);
+	size_t println(unsigned int n, int base = 10);
+	size_t println(long n, int base = 10);
+	size_t println(unsigned long n, int base = 10);
+	size_t println(double n, int digits = 2);
+	size_t println();
+
+private:
+	size_t printNumber(unsigned long n, uint8_t base);
+};
+
+class Stream : public Print
+{
+public:
+	virtual int available() = 0;
+	virtual int read() = 0;
+	virtual int peek() = 0;
+	void setTimeout(unsigned long timeout) { _timeout = timeout; }
+	size_t readBytes(char* buffer, size_t length);
+protected:
+	unsigned long _timeout = 1000;
+};
+
+//Thrown when the library waits for input the test never provided
+struct MockInputExhausted {};
+
+class HardwareSerial : public Stream
+{
+public:
+	void begin(unsigned long) {}
+	void end() {}
+	operator bool() { return true; }
+
+	int available();
+	int read();
+	int peek();
+	size_t write(uint8_t data);
+	size_t write(const uint8_t* buffer, size_t size);
+	using Print::write;
+	int availableForWrite() { return _write_room; }
+
+	//Test controls
+	void feed(const char* text);
+	void feed(const uint8_t* data, size_t length);
+	std::string& output() { return _output; }
+	void clear();
+	unsigned long writeCalls() { return _write_calls; }
+	void setWriteRoom(int room) { _write_room = room; }//Room in the transmit buffer
+
+private:
+	std::deque<uint8_t> _input;
+	std::string _output;
+	unsigned long _write_calls = 0;
+	unsigned long _idle_polls = 0;
+	int _write_room = 64;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;//A second port for sketches that keep Serial for themselves
+
+#endif
@@ -0,0 +1,86 @@
+#include "PtyStream.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+PtyStream::~PtyStream()
+{
+	if(_fd >= 0)
+	{
+		close(_fd);
+	}
+}
+
+bool PtyStream::open()
+{
+	_fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if(_fd < 0 || grantpt(_fd) != 0 || unlockpt(_fd) != 0)
+	{
+		return false;
+	}
+	//Bytes pass through untouched, like a serial port
+	struct termios settings;
+	tcgetattr(_fd, &settings);
+	cfmakeraw(&settings);
+	tcsetattr(_fd, TCSANOW, &settings);
+	return true;
+}
+
+const char* PtyStream::name()
+{
+	return ptsname(_fd);
+}
+
+int PtyStream::available()
+{
+	int waiting = 0;
+	if(ioctl(_fd, FIONREAD, &waiting) != 0)
+	{
+		waiting = 0;
+	}
+	return waiting + (_peeked >= 0);
+}
+
+int PtyStream::read()
+{
+	if(_peeked >= 0)
+	{
+		int data = _peeked;
+		_peeked = -1;
+		return data;
+	}
+	uint8_t data;
+	return ::read(_fd, &data, 1) == 1 ? data : -1;
+}
+
+int PtyStream::peek()
+{
+	if(_peeked < 0)
+	{
+		_peeked = read();
+	}
+	return _peeked;
+}
+
+size_t PtyStream::write(uint8_t data)
+{
+	return write(&data, 1);
+}
+
+size_t PtyStream::write(const uint8_t* buffer, size_t size)
+{
+	size_t sent = 0;
+	while(sent < size)
+	{
+		ssize_t count = ::write(_fd, buffer + sent, size - sent);
+		if(count < 0)
+		{
+			usleep(100);//Wait for the other end to read
+			continue;
+		}
+		sent += count;
+	}
+	return sent;
+}
@@ -0,0 +1,30 @@
+#ifndef _PTY_STREAM_H_
+#define _PTY_STREAM_H_
+//A Stream on the master side of a Linux pseudo terminal.  The library
+//built for the host can be driven through the pty's slave device by a
+//real host tool (Ex: extras/tools/debug_log.py --port) or by a test.
+#include <Arduino.h>
+
+class PtyStream : public Stream
+{
+public:
+	~PtyStream();
+
+	//Create the pty in raw mode, false if none is available
+	bool open();
+	//Device for the other end to open (Ex: /dev/pts/3)
+	const char* name();
+
+	int available();
+	int read();
+	int peek();
+	size_t write(uint8_t data);
+	size_t write(const uint8_t* buffer, size_t size);
+	using Print::write;
+
+private:
+	int _fd = -1;
+	int _peeked = -1;
+};
+
+#endif
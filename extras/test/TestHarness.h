@@ -0,0 +1,67 @@
+#ifndef _TEST_HARNESS_H_
+#define _TEST_HARNESS_H_
+//Minimal test runner for the host build, every TEST() registers itself
+//and test_main.cpp runs them all.
+#include <Arduino.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+typedef void (*TestFunction)();
+
+struct TestCase
+{
+	const char* name;
+	TestFunction run;
+};
+
+std::vector<TestCase>& testCases();
+extern int test_failures;
+
+struct TestRegistrar
+{
+	TestRegistrar(const char* name, TestFunction run)
+	{
+		TestCase test = {name, run};
+		testCases().push_back(test);
+	}
+};
+
+#define TEST(name) \
+	static void name(); \
+	static TestRegistrar name##_registrar(#name, name); \
+	static void name()
+
+#define CHECK(condition) \
+	do { if(!(condition)) { \
+		printf("  %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+		test_failures++; } } while(0)
+
+#define CHECK_EQUAL(expected, actual) \
+	do { long long e_ = (long long)(expected); long long a_ = (long long)(actual); \
+		if(e_ != a_) { \
+			printf("  %s:%d: expected %s == %lld, got %lld\n", __FILE__, __LINE__, #actual, e_, a_); \
+			test_failures++; } } while(0)
+
+//Text the debugger sent contains the given text
+#define CHECK_OUTPUT(text) \
+	do { if(Serial.output().find(text) == std::string::npos) { \
+		printf("  %s:%d: output is missing \"%s\"\n", __FILE__, __LINE__, text); \
+		test_failures++; } } while(0)
+
+//A frame sent by the debugger
+struct Frame
+{
+	byte opcode;
+	std::vector<byte> payload;
+	bool valid;//Checksum matched
+};
+
+//The bytes of a command frame
+std::vector<byte> commandFrame(byte opcode, const std::vector<byte> &payload = std::vector<byte>());
+//Queue a command frame for the debugger to read
+void sendCommand(byte opcode, const std::vector<byte> &payload = std::vector<byte>(), HardwareSerial &port = Serial);
+//Split everything the debugger has sent into frames
+std::vector<Frame> receivedFrames(const std::string &out = Serial.output());
+
+#endif
@@ -0,0 +1,106 @@
+//Paged & summary views of large arrays
+#include "TestHarness.h"
+#include <ArduinoDebugger.h>
+#include <ArduinoDebuggerF.h>
+
+static int samples[1000];
+
+TEST(large_array_shows_one_page)
+{
+	ArduinoDebugger debugger(true, false);
+	for(int i = 0; i < 1000; i++)
+	{
+		samples[i] = i;
+	}
+	debugger.add(samples, "samples");
+	debugger.displayVariables();
+	CHECK_OUTPUT("samples[15]: 15");
+	CHECK(Serial.output().find("samples[16]") == std::string::npos);
+	CHECK_OUTPUT("Showing [0] to [15] of 1000");
+}
+
+TEST(array_menu_pages)
+{
+	ArduinoDebugger debugger(true, false);
+	for(int i = 0; i < 1000; i++)
+	{
+		samples[i] = i;
+	}
+	debugger.add(samples, "samples");
+	//Variables, samples, next page twice, previous page
+	Serial.feed("2\n0\nn\nn\np\nq\nq\nq\n");
+	debugger.breakpoint("loop");
+	CHECK_OUTPUT("Showing [32] to [47] of 1000");
+	CHECK_OUTPUT("samples[47]: 47");
+	CHECK(Serial.output().find("samples[48]") == std::string::npos);
+}
+
+TEST(updating_an_element_shows_its_page)
+{
+	ArduinoDebugger debugger(true, false);
+	debugger.add(samples, "samples");
+	Serial.feed("2\n0\n999\n-5\nq\nq\nq\n");
+	debugger.breakpoint("loop");
+	CHECK_EQUAL(-5, samples[999]);
+	CHECK_OUTPUT("samples[999]: -5");
+	CHECK_OUTPUT("Showing [992] to [999] of 1000");
+}
+
+TEST(array_summary)
+{
+	ArduinoDebugger debugger(true, false);
+	for(int i = 0; i < 1000; i++)
+	{
+		samples[i] = i - 100;
+	}
+	debugger.add(samples, "samples");
+	debugger.displaySummary(0);
+	CHECK_OUTPUT("samples (1000 elements)");
+	CHECK_OUTPUT("min: -100, max: 899, mean: 399");
+	CHECK_OUTPUT("first: -100, -99, -98, -97, -96, -95, -94, -93");
+	int pair[2] = {-1, 2};
+	int three[3] = {-5, 3, 3};
+	int negative[2] = {1, -4};
+	debugger.add(pair, "pair");
+	debugger.add(three, "three");
+	debugger.add(negative, "negative");
+	Serial.clear();
+	debugger.displaySummary(1);
+	CHECK_OUTPUT("mean: 0\r\n");//0.5 rounded towards zero
+	Serial.clear();
+	debugger.displaySummary(2);
+	CHECK_OUTPUT("mean: 0\r\n");
+	Serial.clear();
+	debugger.displaySummary(3);
+	CHECK_OUTPUT("mean: -1\r\n");
+}
+
+TEST(long_summary_does_not_overflow)
+{
+	ArduinoDebugger debugger(true, false);
+	long big[4] = {2000000000L, 2000000000L, 2000000000L, 2000000001L};
+	debugger.add(big, "big");
+	debugger.displaySummary(0);
+	CHECK_OUTPUT("mean: 2000000000");
+}
+
+TEST(float_summary_from_menu)
+{
+	ArduinoDebuggerF debugger(true, false);
+	float gains[3] = {1.5, 3.0, -1.5};
+	debugger.add(gains, "gains");
+	Serial.feed("2\n0\ns\nq\nq\nq\n");
+	debugger.breakpoint("loop");
+	CHECK_OUTPUT("min: -1.50, max: 3.00, mean: 1.00");
+}
+
+TEST(element_window)
+{
+	ArduinoDebugger debugger(true, false);
+	byte levels[40] = {0};
+	levels[30] = 9;
+	debugger.add(levels, "levels");
+	debugger.displayElements(0, 28, 4);
+	CHECK_OUTPUT("levels[30]: 9");
+	CHECK_OUTPUT("Showing [28] to [31] of 40");
+}
@@ -0,0 +1,89 @@
+//Breaking in from the host without a breakpoint() in the sketch
+#include "TestHarness.h"
+#include <ArduinoDebugger.h>
+
+TEST(checkpoint_without_request_runs_on)
+{
+	ArduinoDebugger debugger(true, false);
+	Serial.feed("noise");
+	debugger.serviceBreakIn();
+	debugger.checkpoint();
+	CHECK(Serial.output().empty());
+}
+
+TEST(break_in_sequence_starts_menu)
+{
+	ArduinoDebugger debugger(true, false);
+	std::vector<byte> frame = commandFrame(OP_BREAK);
+	Serial.feed("xx\xA5");//A sync byte that doesn't start the sequence
+	Serial.feed(frame.data(), 2);
+	debugger.serviceBreakIn();
+	debugger.checkpoint();
+	CHECK(Serial.output().empty());
+	Serial.feed(frame.data() + 2, frame.size() - 2);//Rest of the sequence arrives later
+	debugger.serviceBreakIn();
+	Serial.feed("q\n");
+	debugger.checkpoint();
+	CHECK_OUTPUT("Breakpoint - Break-in");
+	Serial.clear();
+	debugger.checkpoint();//The request was answered
+	CHECK(Serial.output().empty());
+}
+
+TEST(poll_answers_break_request)
+{
+	ArduinoDebugger debugger(true, false, true);
+	Probe probes[2];
+	debugger.profileBegin(probes);//Breaking in halts even while profiling
+	sendCommand(OP_BREAK);
+	debugger.poll();
+	sendCommand(OP_CONTINUE);
+	debugger.checkpoint();
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(3, frames.size());//Ack, halt, ack of continue
+	CHECK_EQUAL(OP_ACK, frames[0].opcode);
+	CHECK_EQUAL(OP_HALT, frames[1].opcode);
+	CHECK(std::string(frames[1].payload.begin(), frames[1].payload.end()) == "Break-in");
+}
+
+TEST(break_request_while_halted_is_dropped)
+{
+	ArduinoDebugger debugger(true, false, true);
+	sendCommand(OP_BREAK);
+	sendCommand(OP_CONTINUE);
+	debugger.breakpoint("loop");
+	Serial.clear();
+	debugger.checkpoint();
+	CHECK(Serial.output().empty());
+}
+
+TEST(break_sequence_from_sketch)
+{
+	ArduinoDebugger debugger(true, false);
+	CHECK(debugger.setBreakSequence("!!x"));
+	Serial.feed("!!!x");//The third ! still starts a match
+	debugger.serviceBreakIn();
+	Serial.feed("q\n");
+	debugger.checkpoint();
+	CHECK_OUTPUT("Breakpoint - Break-in");
+}
+
+TEST(break_sequence_that_repeats_itself)
+{
+	ArduinoDebugger debugger(true, false);
+	const byte sequence[] = {'a', 'b', 'a', 'c'};
+	CHECK(debugger.setBreakSequence(sequence, sizeof(sequence)));
+	Serial.feed("ababac");
+	debugger.serviceBreakIn();
+	Serial.feed("q\n");
+	debugger.checkpoint();
+	CHECK_OUTPUT("Breakpoint - Break-in");
+	CHECK(!debugger.setBreakSequence(""));
+	CHECK(!debugger.setBreakSequence("123456789"));
+	std::vector<byte> frame = commandFrame(OP_BREAK);//No longer breaks in
+	Serial.clear();
+	Serial.feed(frame.data(), frame.size());
+	debugger.serviceBreakIn();
+	debugger.checkpoint();
+	CHECK(Serial.output().empty());
+}
@@ -0,0 +1,69 @@
+//Several array elements updated from one line
+#include "TestHarness.h"
+#include <ArduinoDebugger.h>
+#include <ArduinoDebuggerF.h>
+
+TEST(bulk_update_writes_every_value)
+{
+	ArduinoDebugger debugger(true, false);
+	int table[8] = {0};
+	debugger.add(table, "table");
+	//Variables, table, bulk from [2]: 10,-20,30
+	Serial.feed("2\n0\nb\n2\n10,-20,30\r\nq\nq\nq\n");
+	debugger.breakpoint("loop");
+	CHECK_OUTPUT("3 values updated");
+	CHECK_EQUAL(0, table[1]);
+	CHECK_EQUAL(10, table[2]);
+	CHECK_EQUAL(-20, table[3]);
+	CHECK_EQUAL(30, table[4]);
+	CHECK_EQUAL(0, table[5]);
+}
+
+TEST(bulk_update_rejects_the_whole_line)
+{
+	ArduinoDebugger debugger(true, false);
+	byte levels[4] = {1, 2, 3, 4};
+	debugger.add(levels, "levels");
+	Serial.feed("2\n0\nb\n0\n5,300,7\nq\nq\nq\n");
+	debugger.breakpoint("loop");
+	CHECK_OUTPUT("Invalid value for [1]");
+	CHECK_OUTPUT("Nothing updated");
+	CHECK_EQUAL(1, levels[0]);
+	CHECK_EQUAL(3, levels[2]);
+	Serial.clear();
+	Serial.feed("2\n0\nb\n0\n5,0000000000000000006\nq\nq\nq\n");//Too long for a value
+	debugger.breakpoint("loop");
+	CHECK_OUTPUT("Invalid value for [1]");
+	CHECK_EQUAL(1, levels[0]);
+	CHECK_EQUAL(2, levels[1]);
+}
+
+TEST(bulk_update_stops_at_the_end)
+{
+	ArduinoDebugger debugger(true, false);
+	bool flags[3] = {false, false, false};
+	debugger.add(flags, "flags");
+	Serial.feed("2\n0\nb\n1\nt,t,t\nq\nq\nq\n");
+	debugger.breakpoint("loop");
+	CHECK_OUTPUT("Too many values");
+	CHECK(!flags[1]);
+	Serial.feed("2\n0\nb\n1\nt,f\nq\nq\nq\n");
+	debugger.breakpoint("loop");
+	CHECK(flags[1]);
+	CHECK(!flags[2]);
+}
+
+TEST(bulk_update_floats)
+{
+	ArduinoDebuggerF debugger(true, false);
+	float gains[4] = {0};
+	debugger.add(gains, "gains");
+	Serial.feed("2\n0\nb\n0\n1.5,2.25,-4\nq\nq\nq\n");
+	debugger.breakpoint("loop");
+	CHECK_EQUAL(1.5, gains[0]);
+	CHECK_EQUAL(2.25, gains[1]);
+	CHECK_EQUAL(-4, gains[2]);
+	Serial.feed("2\n0\nb\n0\n1.5x\nq\nq\nq\n");
+	debugger.breakpoint("loop");
+	CHECK_OUTPUT("Nothing updated");
+}
@@ -0,0 +1,86 @@
+//Conditional breakpoints
+#include "TestHarness.h"
+#include <ArduinoDebugger.h>
+#include <ArduinoDebuggerF.h>
+
+TEST(condition_parsing)
+{
+	ArduinoDebugger debugger(true, false);
+	int count = 0;
+	bool ready = false;
+	int values[2];
+	debugger.add(count, "count");
+	debugger.add(ready, "ready");
+	debugger.add(values, "values");
+	CHECK(debugger.setCondition("count > 5 && ready == true"));
+	CHECK(!debugger.setCondition("count >"));
+	CHECK(!debugger.setCondition("missing == 1"));
+	CHECK(!debugger.setCondition("values == 1"));
+	CHECK(!debugger.setCondition("count == 1 &&"));
+	CHECK(debugger.setCondition(""));
+}
+
+TEST(breakpoint_if)
+{
+	ArduinoDebugger debugger(true, false);
+	int count = 0;
+	debugger.add(count, "count");
+	debugger.breakpointIf("never");//No condition set
+	CHECK(debugger.setCondition("count >= 3"));
+	for(count = 0; count < 3; count++)
+	{
+		debugger.breakpointIf("count");
+	}
+	CHECK(Serial.output().empty());
+	Serial.feed("q\n");
+	debugger.breakpointIf("count");
+	CHECK_OUTPUT("Breakpoint - count");
+}
+
+TEST(float_condition)
+{
+	ArduinoDebuggerF debugger(true, false);
+	float temperature = 25;
+	debugger.add(temperature, "temperature");
+	CHECK(debugger.setCondition("temperature < 30.5"));
+	Serial.feed("q\n");
+	debugger.breakpointIf("hot");
+	CHECK_OUTPUT("Breakpoint - hot");
+}
+
+TEST(condition_follows_removed_watch)
+{
+	ArduinoDebugger debugger(true, false);
+	int a = 0;
+	int b = 9;
+	debugger.add(a, "a");
+	debugger.add(b, "b");
+	CHECK(debugger.setCondition("b == 9"));
+	debugger.remove("a");
+	Serial.feed("q\n");
+	debugger.breakpointIf("b");
+	CHECK_OUTPUT("Breakpoint - b");
+}
+
+TEST(condition_from_menu)
+{
+	ArduinoDebugger debugger(true, false);
+	int count = 0;
+	debugger.add(count, "count");
+	Serial.feed("3\ncount != 0\nq\n");
+	debugger.breakpoint();
+	debugger.breakpointIf("zero");
+	CHECK(Serial.output().find("Breakpoint - zero") == std::string::npos);
+}
+
+TEST(long_condition_is_refused)
+{
+	ArduinoDebugger debugger(true, false);
+	long count = 0;
+	debugger.add(count, "count");
+	Serial.feed("3\ncount < 1234567890123456 && count < 1234567890123456\n\nq\n");
+	debugger.breakpoint();
+	CHECK_OUTPUT("Condition too long");
+	debugger.breakpointIf("zero");
+	CHECK(Serial.output().find("Breakpoint - zero") == std::string::npos);
+}
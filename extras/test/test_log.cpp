@@ -0,0 +1,53 @@
+//Deferred formatting log frames
+#define DEBUG_LOG_LEVEL DEBUG_LEVEL_INFO
+#include "TestHarness.h"
+#include <DebugLog.h>
+
+static int evaluated = 0;
+
+static int sideEffect()
+{
+	evaluated++;
+	return 1;
+}
+
+TEST(log_sends_id_and_raw_arguments)
+{
+	int speed = -2;
+	long total = 70000;
+	DEBUG_LOG_INFO("speed %d total %ld", speed, total);
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(1, frames.size());
+	CHECK(frames[0].valid);
+	CHECK_EQUAL(OP_LOG, frames[0].opcode);
+	CHECK_EQUAL(2 + sizeof(int) + sizeof(long), frames[0].payload.size());
+	uint16_t id = frames[0].payload[0] | (frames[0].payload[1] << 8);
+	CHECK_EQUAL(debugHash("I:speed %d total %ld"), id);
+	int sent_speed;
+	memcpy(&sent_speed, &frames[0].payload[2], sizeof(int));
+	CHECK_EQUAL(-2, sent_speed);
+	CHECK(Serial.output().find("speed") == std::string::npos);//The format never leaves
+}
+
+TEST(log_strings_are_cut_short)
+{
+	char name[64];
+	memset(name, 'x', sizeof(name) - 1);
+	name[63] = 0;
+	DEBUG_LOG_WARN("%s %c", name, 'y');
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(2 + DEBUG_LOG_TEXT + 1 + 1, frames[0].payload.size());
+	CHECK_EQUAL(0, frames[0].payload[2 + DEBUG_LOG_TEXT]);
+	CHECK_EQUAL('y', frames[0].payload[3 + DEBUG_LOG_TEXT]);
+}
+
+TEST(levels_above_threshold_compile_away)
+{
+	DEBUG_LOG_DEBUG("never %d", sideEffect());
+	CHECK_EQUAL(0, evaluated);
+	CHECK(Serial.output().empty());
+	DEBUG_LOG_ERROR("always %d", sideEffect());
+	CHECK_EQUAL(1, evaluated);
+	DEBUG_LOG_ERROR("no arguments");
+	CHECK_EQUAL(2, receivedFrames().size());
+}
@@ -0,0 +1,95 @@
+#include "TestHarness.h"
+
+int test_failures = 0;
+
+std::vector<TestCase>& testCases()
+{
+	static std::vector<TestCase> cases;
+	return cases;
+}
+
+std::vector<byte> commandFrame(byte opcode, const std::vector<byte> &payload)
+{
+	std::vector<byte> frame;
+	frame.push_back(0xA5);
+	frame.push_back(payload.size());
+	frame.push_back(opcode);
+	byte sum = payload.size() + opcode;
+	for(size_t i = 0; i < payload.size(); i++)
+	{
+		frame.push_back(payload[i]);
+		sum += payload[i];
+	}
+	frame.push_back(-sum);
+	return frame;
+}
+
+void sendCommand(byte opcode, const std::vector<byte> &payload, HardwareSerial &port)
+{
+	std::vector<byte> frame = commandFrame(opcode, payload);
+	port.feed(frame.data(), frame.size());
+}
+
+std::vector<Frame> receivedFrames(const std::string &out)
+{
+	std::vector<Frame> frames;
+	size_t pos = 0;
+	while(pos + 4 <= out.size())
+	{
+		if((byte)out[pos] != 0xA5)
+		{
+			pos++;
+			continue;
+		}
+		byte length = out[pos + 1];
+		if(pos + 4 + length > out.size())
+		{
+			break;
+		}
+		Frame frame;
+		frame.opcode = out[pos + 2];
+		byte sum = length + frame.opcode;
+		for(byte i = 0; i < length; i++)
+		{
+			frame.payload.push_back(out[pos + 3 + i]);
+			sum += (byte)out[pos + 3 + i];
+		}
+		sum += (byte)out[pos + 3 + length];
+		frame.valid = sum == 0;
+		frames.push_back(frame);
+		pos += 4 + length;
+	}
+	return frames;
+}
+
+int main(int argc, char* argv[])
+{
+	int failed_tests = 0;
+	std::vector<TestCase> &cases = testCases();
+	for(size_t i = 0; i < cases.size(); i++)
+	{
+		if(argc > 1 && std::string(argv[1]) != cases[i].name)
+		{
+			continue;
+		}
+		mock_reset();
+		int before = test_failures;
+		try
+		{
+			cases[i].run();
+		}
+		catch(MockInputExhausted&)
+		{
+			printf("  %s waited for input the script never sent\n", cases[i].name);
+			test_failures++;
+		}
+		bool passed = test_failures == before;
+		printf("%s %s\n", passed ? "PASS" : "FAIL", cases[i].name);
+		if(!passed)
+		{
+			failed_tests++;
+		}
+	}
+	printf("%d of %d tests failed\n", failed_tests, (int)cases.size());
+	return failed_tests == 0 ? 0 : 1;
+}
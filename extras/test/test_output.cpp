@@ -0,0 +1,50 @@
+//Output buffering & number input
+#include "TestHarness.h"
+#include <ArduinoDebugger.h>
+
+TEST(output_is_batched)
+{
+	DebugOutput out;
+	out.print(F("0123456789"));
+	CHECK_EQUAL(0, Serial.writeCalls());
+	out.repeat('*', 50);
+	CHECK(Serial.writeCalls() > 0);
+	out.flush();
+	CHECK_EQUAL(60, Serial.output().size());
+	CHECK_EQUAL(60, out.count());
+	CHECK_EQUAL(2, Serial.writeCalls());
+}
+
+TEST(display_uses_few_writes)
+{
+	ArduinoDebugger debugger(true, false);
+	debugger.displayPins();
+	CHECK(Serial.writeCalls() <= Serial.output().size() / DEBUG_OUTPUT_BUFFER + 1);
+}
+
+TEST(parse_number)
+{
+	ArduinoDebugger debugger(true, false);
+	bool valid;
+	CHECK_EQUAL(-12, debugger.parseNumber("-12", valid, INT));
+	CHECK(valid);
+	debugger.parseNumber("12x", valid, INT);
+	CHECK(!valid);
+	debugger.parseNumber("256", valid, BYTE);
+	CHECK(!valid);
+	debugger.parseNumber("99999999999999999999999", valid, LONG);
+	CHECK(!valid);
+	CHECK_EQUAL(7, debugger.parseNumber("7", valid, LONG));
+	CHECK(valid);
+}
+
+TEST(custom_terminator)
+{
+	ArduinoDebugger debugger(true, true);
+	int count = 0;
+	debugger.add(count, "count");
+	debugger.setTerminator(';');
+	Serial.feed("2;0;15;q;q;");
+	debugger.breakpoint();
+	CHECK_EQUAL(15, count);
+}
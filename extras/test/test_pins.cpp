@@ -0,0 +1,102 @@
+//Pin snapshots, the full pin view and the change view
+#include "TestHarness.h"
+#include <ArduinoDebugger.h>
+
+TEST(pin_states)
+{
+	ArduinoDebugger debugger(true, false);
+	pinMode(13, OUTPUT);
+	digitalWrite(13, HIGH);
+	mock_setInput(2, HIGH);
+	mock_setAnalog(A3, 512);
+	debugger.displayPins();
+	CHECK_OUTPUT("13 : HIGH\r\n");
+	CHECK_OUTPUT("2 : HIGH(Power In)\r\n");
+	CHECK_OUTPUT("12 : LOW\r\n");
+	CHECK_OUTPUT("A3 : 512\r\n");
+}
+
+TEST(pin_states_32_bit_registers)
+{
+	ArduinoDebugger debugger(false, false);//SAMD style 32 bit port registers
+	pinMode(9, OUTPUT);
+	digitalWrite(9, HIGH);
+	mock_setInput(5, HIGH);
+	debugger.displayPins();
+	CHECK_OUTPUT("9 : HIGH\r\n");
+	CHECK_OUTPUT("5 : HIGH(Power In)\r\n");
+	CHECK_OUTPUT("8 : LOW\r\n");
+}
+
+TEST(snapshot_reads_registers_not_pins)
+{
+	ArduinoDebugger debugger(true, false);
+	debugger.displayPins();
+	CHECK_EQUAL(0, mock_digital_reads);
+}
+
+TEST(chosen_pins)
+{
+	ArduinoDebugger debugger(true, false);
+	byte digital[] = {3, 4};
+	byte analog[] = {A0};
+	mock_setInput(4, HIGH);
+	debugger.displayPins(digital, analog);
+	CHECK_OUTPUT("4 : HIGH(Power In)");
+	CHECK(Serial.output().find("5 : ") == std::string::npos);
+	CHECK(Serial.output().find("A1 : ") == std::string::npos);
+}
+
+TEST(pin_changes)
+{
+	ArduinoDebugger debugger(true, false);
+	debugger.displayPins();
+	CHECK(!debugger.pinsChanged());
+	mock_setInput(7, HIGH);
+	mock_setAnalog(A0, 3);//Inside the dead-band
+	mock_setAnalog(A1, 100);
+	Serial.clear();
+	debugger.displayPinChanges();
+	CHECK_OUTPUT("7 : HIGH(Power In)");
+	CHECK_OUTPUT("A1 : 100");
+	CHECK(Serial.output().find("A0 : ") == std::string::npos);
+	Serial.clear();
+	debugger.displayPinChanges();
+	CHECK_OUTPUT("No pins changed");
+}
+
+TEST(pin_changes_frame)
+{
+	ArduinoDebugger debugger(true, false, true);
+	std::vector<byte> deadband;
+	deadband.push_back(10);
+	deadband.push_back(0);
+	sendCommand(OP_READ_PINS);
+	sendCommand(OP_CONTINUE);
+	debugger.breakpoint();
+	pinMode(9, OUTPUT);
+	digitalWrite(9, HIGH);
+	mock_setAnalog(A2, 50);
+	Serial.clear();
+	sendCommand(OP_READ_PIN_CHANGES, deadband);
+	sendCommand(OP_CONTINUE);
+	debugger.breakpoint();
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(OP_PIN_CHANGES, frames[1].opcode);
+	std::vector<byte> &changes = frames[1].payload;
+	CHECK_EQUAL(1, changes[0]);
+	CHECK_EQUAL(9, changes[1]);
+	CHECK_EQUAL(3, changes[2]);//Providing power & reading HIGH
+	CHECK_EQUAL(1, changes[3]);
+	CHECK_EQUAL(2, changes[4]);
+	CHECK_EQUAL(50, changes[5]);
+}
+
+TEST(set_pin_from_menu)
+{
+	ArduinoDebugger debugger(true, false);
+	pinMode(5, OUTPUT);
+	Serial.feed("1\n5\nH\nq\nq\n");
+	debugger.breakpoint();
+	CHECK_EQUAL(HIGH, digitalRead(5));
+}
@@ -0,0 +1,78 @@
+//Debugging through a port other than Serial
+#include "TestHarness.h"
+#include <ArduinoDebugger.h>
+#include <PtyStream.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+TEST(menus_use_their_own_port)
+{
+	ArduinoDebugger debugger(true, false);
+	int count = 5;
+	debugger.add(count, "count");
+	debugger.setPort(Serial1);
+	Serial.feed("q\n");//The sketch's own input is left alone
+	Serial1.feed("2\n0\n42\nq\nq\n");
+	debugger.breakpoint("loop");
+	CHECK_EQUAL(42, count);
+	CHECK(Serial1.output().find("count (int): 5") != std::string::npos);
+	CHECK(Serial.output().empty());
+	CHECK_EQUAL(2, Serial.available());
+}
+
+TEST(protocol_uses_its_own_port)
+{
+	ArduinoDebugger debugger(true, false, true);
+	int count = 5;
+	debugger.add(count, "count");
+	debugger.setPort(Serial1);
+	sendCommand(OP_READ_VAR, std::vector<byte>(1, 0), Serial1);
+	debugger.poll();
+	std::vector<Frame> frames = receivedFrames(Serial1.output());
+	CHECK_EQUAL(1, frames.size());
+	CHECK_EQUAL(OP_VALUE, frames[0].opcode);
+	CHECK(Serial.output().empty());
+}
+
+//Read what the debugger sent through the pty, waiting up to timeout ms for each chunk
+static std::string readPty(int fd, int timeout)
+{
+	std::string text;
+	struct pollfd ready = {fd, POLLIN, 0};
+	char buffer[64];
+	while(::poll(&ready, 1, timeout) > 0)
+	{
+		ssize_t count = ::read(fd, buffer, sizeof(buffer));
+		if(count <= 0)
+		{
+			break;
+		}
+		text.append(buffer, count);
+	}
+	return text;
+}
+
+TEST(poll_through_a_pty)
+{
+	PtyStream pty;
+	CHECK(pty.open());
+	int host = open(pty.name(), O_RDWR | O_NOCTTY);
+	CHECK(host >= 0);
+	ArduinoDebugger debugger(true, false, true);
+	int count = 5;
+	debugger.add(count, "count");
+	debugger.setPort(pty);
+	std::vector<byte> frame = commandFrame(OP_WRITE_VAR, std::vector<byte>({0, 0, 0, 42, 0, 0, 0}));
+	CHECK_EQUAL(frame.size(), write(host, frame.data(), frame.size()));
+	for(int tries = 0; tries < 1000 && count != 42; tries++)
+	{//The pty hands the bytes over asynchronously
+		debugger.poll();
+		usleep(100);
+	}
+	CHECK_EQUAL(42, count);
+	std::vector<Frame> frames = receivedFrames(readPty(host, 100));
+	CHECK_EQUAL(1, frames.size());
+	CHECK_EQUAL(OP_ACK, frames[0].opcode);
+	close(host);
+}
@@ -0,0 +1,63 @@
+//Named breakpoints counted as profiling probes
+#include "TestHarness.h"
+#include <ArduinoDebugger.h>
+
+TEST(probes_count_without_halting)
+{
+	ArduinoDebugger debugger(true, false);
+	Probe probes[2];
+	mock_setTick(0);
+	debugger.profileBegin(probes);
+	for(int i = 0; i < 4; i++)
+	{
+		debugger.breakpoint("loop");
+		mock_advance(i == 2 ? 300 : 100);//100, 100, 300 between hits
+		if(i % 2 == 0)
+		{
+			debugger.breakpoint("even");
+		}
+	}
+	CHECK(Serial.output().empty());
+	CHECK_EQUAL(4, probes[0].hits);
+	CHECK_EQUAL(100, probes[0].shortest);
+	CHECK_EQUAL(300, probes[0].longest);
+	CHECK_EQUAL(2, probes[1].hits);
+	debugger.breakpoint("third");//No room left
+	debugger.displayProfile();
+	CHECK_OUTPUT("loop : 4 hits, 100/166/300 us");
+	CHECK_OUTPUT("even : 2 hits, 400/400/400 us");
+	CHECK_OUTPUT("1 hits of other breakpoints");
+}
+
+TEST(profile_end_halts_again)
+{
+	ArduinoDebugger debugger(true, false);
+	Probe probes[1];
+	debugger.profileBegin(probes);
+	debugger.breakpoint("loop");
+	debugger.profileEnd();
+	Serial.feed("q\n");
+	debugger.breakpoint("loop");
+	CHECK_OUTPUT("Breakpoint - loop");
+}
+
+TEST(profile_frames)
+{
+	ArduinoDebugger debugger(true, false);
+	Probe probes[2];
+	mock_setTick(0);
+	debugger.profileBegin(probes);
+	debugger.breakpoint("a");
+	mock_advance(50);
+	debugger.breakpoint("a");
+	sendCommand(OP_READ_PROFILE);
+	debugger.poll();
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(2, frames.size());
+	CHECK_EQUAL(OP_PROFILE, frames[0].opcode);
+	CHECK_EQUAL(17, frames[0].payload.size());
+	CHECK_EQUAL(2, frames[0].payload[0]);
+	CHECK_EQUAL(50, frames[0].payload[4]);
+	CHECK_EQUAL('a', frames[0].payload[16]);
+	CHECK_EQUAL(OP_ACK, frames[1].opcode);
+}
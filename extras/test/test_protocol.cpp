@@ -0,0 +1,335 @@
+//Binary protocol, both while halted and through poll()
+#include "TestHarness.h"
+#include <ArduinoDebugger.h>
+#include <utility>
+
+static std::vector<byte> bytes(std::initializer_list<int> values)
+{
+	std::vector<byte> result;
+	for(int value : values)
+	{
+		result.push_back(value);
+	}
+	return result;
+}
+
+TEST(halted_session)
+{
+	ArduinoDebugger debugger(true, false, true);
+	int count = 5;
+	debugger.add(count, "count");
+	sendCommand(OP_LIST_WATCHES);
+	sendCommand(OP_WRITE_VAR, bytes({0, 0, 0, 42, 0, 0, 0}));
+	sendCommand(OP_READ_VAR, bytes({0}));
+	sendCommand(OP_CONTINUE);
+	debugger.breakpoint("bp");
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(6, frames.size());
+	CHECK_EQUAL(OP_HALT, frames[0].opcode);
+	CHECK(std::string(frames[0].payload.begin(), frames[0].payload.end()) == "bp");
+	CHECK_EQUAL(OP_WATCH, frames[1].opcode);
+	CHECK_EQUAL(INT, frames[1].payload[1]);
+	CHECK_EQUAL(sizeof(int), frames[1].payload[2]);
+	CHECK_EQUAL(OP_ACK, frames[2].opcode);
+	CHECK_EQUAL(OP_ACK, frames[3].opcode);
+	CHECK_EQUAL(OP_VALUE, frames[4].opcode);
+	CHECK_EQUAL(42, frames[4].payload[3]);
+	CHECK_EQUAL(OP_ACK, frames[5].opcode);
+	for(size_t i = 0; i < frames.size(); i++)
+	{
+		CHECK(frames[i].valid);
+	}
+	CHECK_EQUAL(42, count);
+}
+
+TEST(moved_debugger_sends_through_its_own_output)
+{
+	int count = 5;
+	ArduinoDebugger* original = new ArduinoDebugger(true, false, true);
+	original->add(count, "count");
+	ArduinoDebugger debugger(std::move(*original));
+	delete original;
+	sendCommand(OP_READ_VAR, bytes({0}));
+	debugger.poll();
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(1, frames.size());
+	CHECK_EQUAL(OP_VALUE, frames[0].opcode);
+	CHECK_EQUAL(5, frames[0].payload[3]);
+}
+
+TEST(frames_are_written_in_chunks)
+{
+	ArduinoDebugger debugger(true, false);
+	byte a = 0;
+	byte b = 0;
+	byte c = 0;
+	debugger.add(a, "a");
+	debugger.add(b, "b");
+	debugger.add(c, "c");
+	sendCommand(OP_LIST_WATCHES);
+	debugger.poll();
+	CHECK_EQUAL(4, receivedFrames().size());
+	CHECK(Serial.writeCalls() <= Serial.output().size() / DEBUG_OUTPUT_BUFFER + 1);
+}
+
+TEST(bad_frames_are_refused)
+{
+	ArduinoDebugger debugger(true, false, true);
+	byte flags[4] = {0};
+	debugger.add(flags, "flags");
+	byte corrupt[] = {0xA5, 0x00, OP_LIST_WATCHES, 0x00};
+	Serial.feed(corrupt, sizeof(corrupt));
+	sendCommand(0x30);
+	sendCommand(OP_READ_VAR, bytes({3}));
+	sendCommand(OP_WRITE_VAR, bytes({0, 1, 0, 1, 2}));//bool only holds 0/1 but flags is byte
+	sendCommand(OP_WRITE_VAR, bytes({0, 3, 0, 1, 1}));//Runs past the end
+	sendCommand(OP_CONTINUE);
+	debugger.breakpoint();
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(7, frames.size());
+	CHECK_EQUAL(OP_NAK, frames[1].opcode);
+	CHECK_EQUAL(ERR_CHECKSUM, frames[1].payload[0]);
+	CHECK_EQUAL(ERR_OPCODE, frames[2].payload[0]);
+	CHECK_EQUAL(ERR_INDEX, frames[3].payload[0]);
+	CHECK_EQUAL(OP_ACK, frames[4].opcode);
+	CHECK_EQUAL(ERR_INDEX, frames[5].payload[0]);
+	CHECK_EQUAL(2, flags[2]);
+	CHECK_EQUAL(0, flags[3]);
+}
+
+TEST(array_window)
+{
+	ArduinoDebugger debugger(true, false, true);
+	byte samples[300];
+	for(int i = 0; i < 300; i++)
+	{
+		samples[i] = i;
+	}
+	debugger.add(samples, "samples");
+	sendCommand(OP_READ_VAR, bytes({0, 0x2C, 0x01, 0}));//Empty window at the end
+	sendCommand(OP_READ_VAR, bytes({0, 0x0A, 0x01, 3}));//samples[266..268]
+	sendCommand(OP_READ_VAR, bytes({0}));//Clipped to one frame
+	sendCommand(OP_CONTINUE);
+	debugger.breakpoint();
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(3, frames[1].payload.size());
+	CHECK_EQUAL(6, frames[2].payload.size());
+	CHECK_EQUAL(266 & 0xFF, frames[2].payload[3]);
+	CHECK_EQUAL(255, frames[3].payload.size());
+}
+
+TEST(poll_split_frame)
+{
+	ArduinoDebugger debugger(true, false);
+	long total = 0;
+	debugger.add(total, "total");
+	byte frame[] = {0xA5, 0x01, OP_READ_VAR, 0x00, (byte)-(0x01 + OP_READ_VAR)};
+	Serial.feed(frame, 2);
+	debugger.poll();
+	CHECK(Serial.output().empty());
+	Serial.feed(frame + 2, 3);
+	debugger.poll();
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(1, frames.size());
+	CHECK_EQUAL(OP_VALUE, frames[0].opcode);
+	CHECK_EQUAL(3 + sizeof(long), frames[0].payload.size());
+}
+
+TEST(poll_runs_one_command_per_call)
+{
+	ArduinoDebugger debugger(true, false);
+	sendCommand(OP_LIST_WATCHES);
+	sendCommand(OP_LIST_WATCHES);
+	debugger.poll();
+	CHECK_EQUAL(1, receivedFrames().size());
+	debugger.poll();
+	CHECK_EQUAL(2, receivedFrames().size());
+}
+
+TEST(poll_sends_long_answers_in_pieces)
+{
+	ArduinoDebugger debugger(true, false);
+	int values[8] = {0};
+	static char names[8][16];
+	for(int i = 0; i < 8; i++)
+	{
+		snprintf(names[i], sizeof(names[i]), "value_number_%d", i);
+		debugger.add(values[i], names[i]);
+	}
+	sendCommand(OP_LIST_WATCHES);
+	sendCommand(OP_READ_VAR, bytes({3}));
+	debugger.poll();
+	size_t first = Serial.output().size();
+	CHECK(first >= DEBUG_POLL_REPLY && first < 2 * DEBUG_POLL_REPLY);
+	CHECK(receivedFrames().size() < 9);
+	for(int i = 0; i < 10; i++)
+	{
+		debugger.poll();
+	}
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(10, frames.size());//8 watches, the ACK, then the next command's answer
+	CHECK_EQUAL(OP_WATCH, frames[7].opcode);
+	CHECK_EQUAL(7, frames[7].payload[0]);
+	CHECK_EQUAL(OP_ACK, frames[8].opcode);
+	CHECK_EQUAL(OP_VALUE, frames[9].opcode);
+}
+
+TEST(halting_finishes_a_polled_answer)
+{
+	ArduinoDebugger debugger(true, false, true);
+	int values[8] = {0};
+	static char names[8][16];
+	for(int i = 0; i < 8; i++)
+	{
+		snprintf(names[i], sizeof(names[i]), "value_number_%d", i);
+		debugger.add(values[i], names[i]);
+	}
+	sendCommand(OP_READ_TABLE);
+	debugger.poll();
+	sendCommand(OP_CONTINUE);
+	debugger.breakpoint("bp");
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(12, frames.size());//Table, 8 watches, ACK, halt, ACK
+	CHECK_EQUAL(OP_TABLE, frames[0].opcode);
+	CHECK_EQUAL(OP_ACK, frames[9].opcode);
+	CHECK_EQUAL(OP_HALT, frames[10].opcode);
+}
+
+TEST(write_pin)
+{
+	ArduinoDebugger debugger(true, false, true);
+	pinMode(13, OUTPUT);
+	sendCommand(OP_WRITE_PIN, bytes({13, 1}));
+	sendCommand(OP_WRITE_PIN, bytes({NUM_DIGITAL_PINS, 1}));
+	sendCommand(OP_CONTINUE);
+	debugger.breakpoint();
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(OP_ACK, frames[1].opcode);
+	CHECK_EQUAL(ERR_VALUE, frames[2].payload[0]);
+	CHECK_EQUAL(HIGH, digitalRead(13));
+}
+
+TEST(watch_table_handshake)
+{
+	ArduinoDebugger debugger(true, false);
+	int count = 5;
+	long total = 7;
+	byte levels[3] = {1, 2, 3};
+	debugger.add(count, "count");
+	debugger.add(total, "total");
+	debugger.add(levels, "levels");
+	sendCommand(OP_READ_TABLE);
+	debugger.poll();
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(5, frames.size());
+	CHECK_EQUAL(OP_TABLE, frames[0].opcode);
+	CHECK_EQUAL(debugger.generation(), frames[0].payload[0]);
+	CHECK_EQUAL(3, frames[0].payload[1]);
+	CHECK_EQUAL(DEBUG_WATCHES, frames[0].payload[2]);
+	CHECK_EQUAL(OP_WATCH, frames[3].opcode);
+	CHECK_EQUAL(OP_ACK, frames[4].opcode);
+	Serial.clear();
+	sendCommand(OP_READ_VALUES, bytes({2, 0}));
+	debugger.poll();
+	frames = receivedFrames();
+	CHECK_EQUAL(1, frames.size());
+	CHECK_EQUAL(OP_VALUES, frames[0].opcode);
+	CHECK_EQUAL(1 + 3 + sizeof(int), frames[0].payload.size());
+	CHECK_EQUAL(1, frames[0].payload[1]);
+	CHECK_EQUAL(3, frames[0].payload[3]);
+	CHECK_EQUAL(5, frames[0].payload[4]);
+}
+
+TEST(generation_changes_with_the_table)
+{
+	ArduinoDebugger debugger(true, false);
+	int a = 1;
+	int b = 2;
+	byte start = debugger.generation();
+	byte id = debugger.add(a, "a");
+	CHECK(debugger.generation() != start);
+	byte added = debugger.generation();
+	debugger.add(b, "a");//Same name, only moves the watch
+	debugger.updateWatch(id, a);
+	CHECK_EQUAL(added, debugger.generation());
+	debugger.removeWatch(id);
+	CHECK(debugger.generation() != added);
+	sendCommand(OP_READ_VALUES, bytes({id}));
+	debugger.poll();
+	CHECK_EQUAL(ERR_INDEX, receivedFrames()[0].payload[0]);
+}
+
+TEST(values_must_fit_one_frame)
+{
+	ArduinoDebugger debugger(true, false);
+	byte big[200];
+	byte id = debugger.add(big, "big");
+	sendCommand(OP_READ_VALUES, bytes({id, id}));
+	debugger.poll();
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(OP_NAK, frames[0].opcode);
+	CHECK_EQUAL(ERR_LENGTH, frames[0].payload[0]);
+}
+
+TEST(poll_keeps_reads_inside_its_window)
+{
+	ArduinoDebugger debugger(true, false);
+	byte samples[100] = {0};
+	int pair[2] = {0};
+	byte samples_id = debugger.add(samples, "samples");
+	byte pair_id = debugger.add(pair, "pair");
+	sendCommand(OP_READ_VAR, bytes({samples_id}));
+	debugger.poll();
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(1, frames.size());
+	CHECK_EQUAL(DEBUG_POLL_REPLY - 4, frames[0].payload.size());//The host asks for the rest
+	CHECK_EQUAL(DEBUG_POLL_REPLY, Serial.output().size());
+	Serial.clear();
+	sendCommand(OP_READ_VALUES, bytes({samples_id}));
+	debugger.poll();
+	sendCommand(OP_READ_VALUES, bytes({pair_id}));
+	debugger.poll();
+	frames = receivedFrames();
+	CHECK_EQUAL(OP_NAK, frames[0].opcode);
+	CHECK_EQUAL(OP_VALUES, frames[1].opcode);
+}
+
+TEST(poll_waits_for_room_on_the_port)
+{
+	ArduinoDebugger debugger(true, false);
+	int count = 5;
+	debugger.add(count, "count");
+	sendCommand(OP_READ_VAR, bytes({0}));
+	debugger.poll();//An empty transmit buffer
+	CHECK_EQUAL(1, receivedFrames().size());
+	Serial.setWriteRoom(8);
+	sendCommand(OP_READ_PINS);
+	debugger.poll();
+	CHECK_EQUAL(1, receivedFrames().size());
+	unsigned long reads = mock_analog_reads;
+	debugger.poll();
+	CHECK_EQUAL(reads, mock_analog_reads);//Nothing is read until it can be sent
+	Serial.setWriteRoom(64);
+	debugger.poll();
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(2, frames.size());
+	CHECK_EQUAL(OP_PINS, frames[1].opcode);
+}
+
+TEST(no_text_between_frames)
+{
+	ArduinoDebugger debugger(true, false, true);
+	int values[DEBUG_WATCHES + 1] = {0};
+	static char names[DEBUG_WATCHES + 1][4];
+	for(int i = 0; i <= DEBUG_WATCHES; i++)
+	{
+		snprintf(names[i], sizeof(names[i]), "v%d", i);
+		debugger.add(values[i], names[i]);//The last one doesn't fit
+	}
+	debugger.remove((char*)"missing");
+	float level = 1;
+	debugger.remove((char*)"v0");
+	debugger.add(level, "level");
+	CHECK(!debugger.setCondition((char*)"level > 1.5"));//No float parser
+	CHECK(Serial.output().empty());
+}
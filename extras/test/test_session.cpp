@@ -0,0 +1,159 @@
+//Scripted text menu sessions, as typed into the Serial Monitor
+#include "TestHarness.h"
+#include <ArduinoDebugger.h>
+#include <ArduinoDebuggerF.h>
+#include <Debugger.h>
+
+TEST(quit_from_main_menu)
+{
+	ArduinoDebugger debugger(true, false);
+	Serial.feed("q\n");
+	debugger.breakpoint("start");
+	CHECK_OUTPUT("Breakpoint - start");
+	CHECK_OUTPUT("Continuing Program");
+	CHECK_EQUAL(0, Serial.available());
+}
+
+TEST(update_int_and_array)
+{
+	ArduinoDebugger debugger(true, false);
+	int count = 5;
+	int values[3] = {1, 2, 3};
+	bool ready = false;
+	debugger.add(count, "count");
+	debugger.add(values, "values");
+	debugger.add(ready, "ready");
+	//Variables, count = 42, values[2] = 77, ready = true, back out
+	Serial.feed("2\r\n0\r\n42\r\n1\r\n2\r\n77\r\nq\r\n2\r\nt\r\nq\r\nq\r\n");
+	debugger.breakpoint("loop");
+	CHECK_EQUAL(42, count);
+	CHECK_EQUAL(77, values[2]);
+	CHECK(ready);
+	CHECK_OUTPUT("values int[]:");
+	CHECK_OUTPUT("values[2]: 77");
+}
+
+TEST(out_of_range_value_is_rejected)
+{
+	ArduinoDebugger debugger(true, false);
+	byte level = 7;
+	debugger.add(level, "level");
+	Serial.feed("2\n0\n300\nq\nq\n");
+	debugger.breakpoint();
+	CHECK_EQUAL(7, level);
+	CHECK_OUTPUT("Value Out of Range");
+}
+
+TEST(line_without_ending_times_out)
+{
+	ArduinoDebugger debugger(true, false);
+	//Serial Monitor set to "No line ending"
+	Serial.feed("q");
+	debugger.breakpoint();
+	CHECK_OUTPUT("Continuing Program");
+}
+
+TEST(float_session)
+{
+	ArduinoDebuggerF debugger(true, false);
+	float temperature = 20.5;
+	debugger.add(temperature, "temperature");
+	Serial.feed("2\n0\n-3.25\nq\nq\n");
+	debugger.breakpoint();
+	CHECK(temperature == -3.25f);
+	CHECK_OUTPUT("temperature (float): 20.50");
+}
+
+TEST(initialize_keeps_floats)
+{
+	ArduinoDebugger debugger = Debugger::initialize(true, true, false);
+	float temperature = 20.5;
+	debugger.add(temperature, "temperature");
+	Serial.feed("2\n0\n-3.25\nq\nq\n");
+	debugger.breakpoint();
+	CHECK(temperature == -3.25f);
+	CHECK_OUTPUT("temperature (float): 20.50");
+}
+
+TEST(float_input_is_checked)
+{
+	ArduinoDebuggerF debugger(true, false);
+	float temperature = 20.5;
+	debugger.add(temperature, "temperature");
+	Serial.feed("2\n0\n1.2.3\n0\n1e\nq\nq\n");
+	debugger.breakpoint();
+	CHECK(temperature == 20.5f);
+	CHECK_OUTPUT("Not a number");
+	Serial.feed("2\n0\n-4e38\nq\nq\n");
+	debugger.breakpoint();
+	CHECK(temperature == 20.5f);
+	CHECK_OUTPUT("Value Out of Range");
+	Serial.feed("2\n0\n-1.5e-2\nq\nq\n");
+	debugger.breakpoint();
+	CHECK(temperature == -0.015f);
+	Serial.feed("2\n0\n0x41AC0000\nq\nq\n");//Raw IEEE bits
+	debugger.breakpoint();
+	CHECK(temperature == 21.5f);
+	Serial.feed("2\n0\n1.2500000000000000001\nq\nq\n");//Too long to hold, isn't cut short
+	debugger.breakpoint();
+	CHECK(temperature == 21.5f);
+	CHECK_OUTPUT("Input too long");
+}
+
+TEST(long_number_is_refused)
+{
+	ArduinoDebugger debugger(true, false);
+	long total = 7;
+	debugger.add(total, "total");
+	Serial.feed("2\n0\n00000000000042\nq\nq\n");
+	debugger.breakpoint();
+	CHECK_EQUAL(7, total);
+	CHECK_OUTPUT("Input too long");
+}
+
+TEST(long_selection_is_refused)
+{
+	ArduinoDebugger debugger(true, false);
+	int a = 1;
+	int b = 2;
+	debugger.add(a, "a");
+	debugger.add(b, "b");
+	Serial.feed("2\n0000000000001\n99\n\nq\nq\n");//Index 1 doesn't fit, 000000000000 would be a
+	debugger.breakpoint();
+	CHECK_OUTPUT("Input too long");
+	CHECK_EQUAL(1, a);
+	CHECK_EQUAL(2, b);
+}
+
+TEST(legacy_add_splits_array_size)
+{
+	ArduinoDebugger debugger(true, false);
+	byte pins[4] = {0};
+	debugger.add(pins, Type::BYTE_ARRAY, "pins_4");
+	debugger.displayVariables();
+	CHECK_OUTPUT("pins byte[]:");
+	CHECK_OUTPUT("pins[3]: 0");
+}
+
+TEST(remove_watch)
+{
+	ArduinoDebugger debugger(true, false);
+	int a = 1;
+	int b = 2;
+	debugger.add(a, "a");
+	debugger.add(b, "b");
+	debugger.remove("a");
+	debugger.displayVariables();
+	CHECK_OUTPUT("[1] b (int): 2");//ids don't move
+	CHECK(Serial.output().find("] a (int)") == std::string::npos);
+}
+
+TEST(screen_bytes_are_counted)
+{
+	ArduinoDebugger debugger(true, true);
+	debugger.clearScreen();
+	debugger.drawStars();
+	debugger.clearScreen();
+	//The escape codes clearing the screen start the next screen
+	CHECK_EQUAL(7 + 52, debugger.lastScreenBytes());
+}
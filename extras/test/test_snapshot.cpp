@@ -0,0 +1,112 @@
+//Change-only variable views
+#include "TestHarness.h"
+#include <ArduinoDebugger.h>
+
+TEST(changes_show_everything_first)
+{
+	ArduinoDebugger debugger(true, false);
+	int speed = 3;
+	int table[20] = {0};
+	uint16_t sums[4];
+	debugger.add(speed, "speed");
+	debugger.add(table, "table");
+	debugger.snapshotBegin(sums);
+	debugger.displayChanges();
+	CHECK_OUTPUT("[0] speed: 3");
+	CHECK_OUTPUT("[1] table[19]: 0");
+}
+
+TEST(changes_show_only_changed_blocks)
+{
+	ArduinoDebugger debugger(true, false);
+	int speed = 3;
+	int table[20] = {0};
+	uint16_t sums[4];
+	debugger.add(speed, "speed");
+	debugger.add(table, "table");
+	debugger.snapshotBegin(sums);
+	debugger.displayChanges();
+	Serial.clear();
+	table[9] = 7;
+	debugger.displayChanges();
+	CHECK(Serial.output().find("speed") == std::string::npos);
+	CHECK_OUTPUT("[1] table[8]: 0");
+	CHECK_OUTPUT("[1] table[9]: 7");
+	CHECK_OUTPUT("[1] table[15]: 0");
+	CHECK(Serial.output().find("table[7]") == std::string::npos);
+	CHECK(Serial.output().find("table[16]") == std::string::npos);
+	Serial.clear();
+	debugger.displayChanges();
+	CHECK_OUTPUT("No variables changed");
+}
+
+TEST(changes_after_adding_a_watch)
+{
+	ArduinoDebugger debugger(true, false);
+	int speed = 3;
+	long total = 9;
+	uint16_t sums[4];
+	debugger.add(speed, "speed");
+	debugger.snapshotBegin(sums);
+	debugger.displayChanges();
+	debugger.add(total, "total");
+	Serial.clear();
+	debugger.displayChanges();
+	CHECK_OUTPUT("[0] speed: 3");
+	CHECK_OUTPUT("[1] total: 9");
+}
+
+TEST(variable_menu_shows_changes)
+{
+	ArduinoDebugger debugger(true, false);
+	int speed = 3;
+	int other = 4;
+	uint16_t sums[2];
+	debugger.add(speed, "speed");
+	debugger.add(other, "other");
+	debugger.snapshotBegin(sums);
+	debugger.displayChanges();
+	speed = 5;
+	Serial.clear();
+	Serial.feed("2\nq\nq\n");
+	debugger.breakpoint("menu");
+	CHECK_OUTPUT("[0] speed: 5");
+	CHECK(Serial.output().find("other") == std::string::npos);
+	Serial.clear();
+	Serial.feed("2\nr\nq\nq\n");
+	debugger.breakpoint("menu");
+	CHECK_OUTPUT("[1] other (int): 4");
+}
+
+TEST(change_frames)
+{
+	ArduinoDebugger debugger(true, false);
+	int speed = 3;
+	byte table[40] = {0};
+	uint16_t sums[6];
+	debugger.add(speed, "speed");
+	debugger.add(table, "table");
+	sendCommand(OP_READ_CHANGES);
+	debugger.poll();
+	CHECK_EQUAL(OP_NAK, receivedFrames()[0].opcode);
+	debugger.snapshotBegin(sums);
+	Serial.clear();
+	sendCommand(OP_READ_CHANGES);
+	debugger.poll();
+	CHECK_EQUAL(3, receivedFrames().size());//Everything at first
+	table[0] = 1;
+	table[39] = 2;
+	Serial.clear();
+	sendCommand(OP_READ_CHANGES);
+	debugger.poll();
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(3, frames.size());
+	CHECK_EQUAL(OP_VALUE, frames[0].opcode);
+	CHECK_EQUAL(1, frames[0].payload[0]);
+	CHECK_EQUAL(0, frames[0].payload[1]);
+	CHECK_EQUAL(3 + 8, frames[0].payload.size());
+	CHECK_EQUAL(1, frames[0].payload[3]);
+	CHECK_EQUAL(32, frames[1].payload[1]);
+	CHECK_EQUAL(2, frames[1].payload[3 + 7]);
+	CHECK_EQUAL(OP_ACK, frames[2].opcode);
+}
@@ -0,0 +1,45 @@
+//Time spent halted in breakpoints
+#include "TestHarness.h"
+#include <ArduinoDebugger.h>
+
+TEST(halt_time_is_recorded)
+{
+	ArduinoDebugger debugger(true, false);
+	mock_setTick(1000);
+	Serial.feed("q\n");
+	unsigned long before = millis();
+	debugger.breakpoint("first");
+	unsigned long after = millis();
+	CHECK(debugger.lastHaltTime() >= 1000);
+	CHECK(after - before >= debugger.lastHaltTime() / 1000);
+	unsigned long first = debugger.lastHaltTime();
+	Serial.feed("q\n");
+	debugger.breakpoint("second");
+	CHECK_EQUAL(first + debugger.lastHaltTime(), debugger.haltedTime());
+}
+
+TEST(compensation_rewinds_the_clock)
+{
+	ArduinoDebugger debugger(true, false);
+	CHECK(debugger.setTimeCompensation(true));
+	mock_setTick(1000);
+	Serial.feed("1\nq\nq\n");//Look at the pins before continuing
+	unsigned long before = millis();
+	debugger.breakpoint("stop");
+	unsigned long after = millis();
+	CHECK(debugger.lastHaltTime() >= 2000);
+	CHECK(after - before <= 2);//Only the calls to millis() around the halt
+}
+
+TEST(compensation_in_protocol_mode)
+{
+	ArduinoDebugger debugger(true, false, true);
+	debugger.setTimeCompensation(true);
+	mock_setTick(500);
+	sendCommand(OP_CONTINUE);
+	unsigned long before = micros();
+	debugger.breakpoint("stop");
+	unsigned long after = micros();
+	CHECK(debugger.lastHaltTime() > 0);
+	CHECK_EQUAL(1000, after - before);
+}
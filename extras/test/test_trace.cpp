@@ -0,0 +1,169 @@
+//Ring buffer trace of watched variables
+#include "TestHarness.h"
+#include <ArduinoDebugger.h>
+#include <DebugTrace.h>
+
+TEST(trace_keeps_newest_records)
+{
+	DebugTrace trace;
+	alignas(TraceChannel) byte buffer[sizeof(TraceChannel) + 3 * (sizeof(unsigned long) + 1)];
+	byte value = 0;
+	trace.begin(buffer, sizeof(buffer), 0);
+	trace.addChannel(&value, 1, 0);
+	CHECK(trace.start());
+	for(value = 1; value <= 5; value++)
+	{
+		trace.trigger();
+	}
+	CHECK_EQUAL(3, trace.count());
+	//Oldest record (value 3) is at the end of the buffer, then it wraps
+	unsigned int length;
+	const byte* data = trace.data(0, length);
+	CHECK_EQUAL(trace.recordSize(), length);
+	CHECK_EQUAL(3, data[sizeof(unsigned long)]);
+	data = trace.data(length, length);
+	CHECK_EQUAL(2 * trace.recordSize(), length);
+	CHECK_EQUAL(4, data[sizeof(unsigned long)]);
+}
+
+TEST(channels_take_room_in_the_buffer)
+{
+	DebugTrace trace;
+	alignas(TraceChannel) byte buffer[sizeof(TraceChannel) + sizeof(unsigned long) + 1];
+	byte value = 0;
+	trace.begin(buffer, sizeof(TraceChannel) - 1, 0);
+	CHECK(!trace.addChannel(&value, 1, 0));
+	trace.begin(buffer, sizeof(buffer) - 1, 0);
+	CHECK(trace.addChannel(&value, 1, 0));
+	CHECK(!trace.start());//No room left for a record
+	trace.begin(buffer, sizeof(buffer), 0);
+	CHECK(trace.addChannel(&value, 1, 0));
+	CHECK(trace.start());
+}
+
+TEST(trace_period)
+{
+	DebugTrace trace;
+	byte buffer[64];
+	mock_setTick(0);
+	trace.begin(buffer, sizeof(buffer), 100);
+	trace.start();
+	trace.trigger();
+	mock_advance(150);
+	trace.trigger();
+	trace.trigger();
+	CHECK_EQUAL(1, trace.count());
+}
+
+TEST(trace_too_small)
+{
+	ArduinoDebugger debugger(true, false);
+	int values[8];
+	debugger.add(values, "values");
+	byte buffer[8];
+	CHECK(!debugger.traceBegin(buffer, sizeof(buffer)));
+}
+
+TEST(dump_trace)
+{
+	ArduinoDebugger debugger(true, false, true);
+	int a = 1;
+	byte b = 2;
+	debugger.add(a, "a");
+	debugger.add(b, "b");
+	alignas(TraceChannel) byte buffer[256];
+	CHECK(debugger.traceBegin(buffer, sizeof(buffer), 0x2));
+	for(int i = 0; i < 100; i++)
+	{
+		b = i;
+		debugger.trace();
+	}
+	debugger.traceEnd();
+	sendCommand(OP_DUMP_TRACE);
+	sendCommand(OP_CONTINUE);
+	debugger.breakpoint();
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(OP_TRACE, frames[1].opcode);
+	unsigned int record_size = sizeof(unsigned long) + 1;
+	unsigned int records = (sizeof(buffer) - sizeof(TraceChannel)) / record_size;
+	CHECK_EQUAL(record_size, frames[1].payload[0]);
+	CHECK_EQUAL(records, frames[1].payload[2]);
+	CHECK_EQUAL(1, frames[1].payload[4]);
+	CHECK_EQUAL(1, frames[1].payload[5]);
+	std::vector<byte> data;
+	size_t i = 2;
+	for(; frames[i].opcode == OP_TRACE_DATA; i++)
+	{
+		data.insert(data.end(), frames[i].payload.begin(), frames[i].payload.end());
+	}
+	CHECK_EQUAL(OP_ACK, frames[i].opcode);
+	CHECK_EQUAL(records * record_size, data.size());
+	CHECK_EQUAL(100 - records, data[record_size - 1]);
+	CHECK_EQUAL(99, data[data.size() - 1]);
+}
+
+TEST(poll_dumps_trace_in_pieces)
+{
+	ArduinoDebugger debugger(true, false);
+	byte b = 0;
+	debugger.add(b, "b");
+	alignas(TraceChannel) byte buffer[250];
+	CHECK(debugger.traceBegin(buffer, sizeof(buffer)));
+	for(int i = 0; i < 100; i++)
+	{
+		b = i;
+		debugger.trace();
+	}
+	sendCommand(OP_DUMP_TRACE);
+	debugger.poll();
+	CHECK(Serial.output().size() < 2 * DEBUG_POLL_REPLY);
+	for(int i = 0; i < 20; i++)
+	{
+		b = 200;
+		debugger.trace();//Not recorded while the dump is being sent
+		debugger.poll();
+	}
+	std::vector<Frame> frames = receivedFrames();
+	unsigned int record_size = sizeof(unsigned long) + 1;
+	unsigned int records = (sizeof(buffer) - sizeof(TraceChannel)) / record_size;
+	std::vector<byte> data;
+	size_t i = 1;
+	for(; frames[i].opcode == OP_TRACE_DATA; i++)
+	{
+		CHECK(frames[i].payload.size() <= DEBUG_POLL_REPLY);
+		data.insert(data.end(), frames[i].payload.begin(), frames[i].payload.end());
+	}
+	CHECK_EQUAL(OP_ACK, frames[i].opcode);
+	CHECK_EQUAL(records * record_size, data.size());
+	CHECK_EQUAL(100 - records, data[record_size - 1]);
+	CHECK_EQUAL(99, data[data.size() - 1]);
+}
+
+TEST(trace_follows_a_re_added_local)
+{
+	ArduinoDebugger debugger(true, false, true);
+	byte first = 1;
+	byte second = 2;
+	debugger.add(first, "local");
+	alignas(TraceChannel) byte buffer[sizeof(TraceChannel) + 3 * (sizeof(unsigned long) + 1)];
+	CHECK(debugger.traceBegin(buffer, sizeof(buffer)));
+	debugger.trace();
+	debugger.add(second, "local");//The next pass's copy
+	first = 9;
+	debugger.trace();
+	debugger.remove((char*)"local");
+	second = 7;
+	debugger.trace();
+	sendCommand(OP_DUMP_TRACE);
+	sendCommand(OP_CONTINUE);
+	debugger.breakpoint();
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(OP_TRACE, frames[1].opcode);
+	CHECK_EQUAL(255, frames[1].payload[5]);//The watch is gone
+	std::vector<byte> &data = frames[2].payload;
+	unsigned int record_size = sizeof(unsigned long) + 1;
+	CHECK_EQUAL(3 * record_size, data.size());
+	CHECK_EQUAL(1, data[record_size - 1]);
+	CHECK_EQUAL(2, data[2 * record_size - 1]);
+	CHECK_EQUAL(0, data[3 * record_size - 1]);
+}
@@ -0,0 +1,205 @@
+//The watch table
+#include "TestHarness.h"
+#include <ArduinoDebugger.h>
+#include <ArduinoDebuggerF.h>
+#include <utility>
+
+TEST(sketch_sized_table)
+{
+	Variable watches[2];
+	ArduinoDebugger debugger(watches, true, false);
+	int a = 1;
+	int b = 2;
+	int c = 3;
+	debugger.add(a, "a");
+	debugger.add(b, "b");
+	CHECK(Serial.output().empty());
+	debugger.add(c, "c");
+	CHECK_OUTPUT("Can't add c");
+	CHECK(watches[1].ptr == &b);
+}
+
+TEST(default_table)
+{
+	ArduinoDebugger debugger(true, false);
+	int values[DEBUG_WATCHES + 1];
+	static char names[DEBUG_WATCHES + 1][4];
+	for(int i = 0; i <= DEBUG_WATCHES; i++)
+	{
+		snprintf(names[i], sizeof(names[i]), "v%d", i);
+		debugger.add(values[i], names[i]);
+	}
+	CHECK_OUTPUT("Too many variables in watch");
+}
+
+TEST(flash_names)
+{
+	Variable watches[3];
+	ArduinoDebuggerF debugger(watches, true, false);
+	float level = 2.5;
+	byte codes[3] = {7, 8, 9};
+	debugger.add(level, F("level"));
+	debugger.add(codes, F("codes"));
+	debugger.add(level, "level");//Already watched under the same name
+	CHECK(watches[0].flash_name);
+	debugger.displayVariables();
+	CHECK_OUTPUT("[0] level (float): 2.50");
+	CHECK_OUTPUT("[1] codes byte[]:");
+	CHECK_OUTPUT("codes[2]: 9");
+	CHECK(debugger.setCondition("level > 2"));
+	debugger.remove(F("level"));
+	Serial.clear();
+	debugger.displayVariables();
+	CHECK_OUTPUT("[1] codes");
+	CHECK(Serial.output().find("[0] level") == std::string::npos);
+}
+
+TEST(long_names)
+{
+	Variable watches[1];
+	ArduinoDebugger debugger(watches, true, false);
+	int reading = 0;
+	debugger.add(reading, "aVeryLongSensorReadingName");
+	debugger.displayVariables();
+	CHECK_OUTPUT("aVeryLongSensorReadingName (int): 0");
+}
+
+TEST(sized_name_in_protocol)
+{
+	ArduinoDebugger debugger(true, false, true);
+	int pins[20];
+	debugger.add(pins, Type::INT_ARRAY, "pins_20");
+	sendCommand(OP_LIST_WATCHES);
+	sendCommand(OP_CONTINUE);
+	debugger.breakpoint();
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(OP_WATCH, frames[1].opcode);
+	CHECK_EQUAL(20, frames[1].payload[3]);
+	CHECK(std::string(frames[1].payload.begin() + 5, frames[1].payload.end()) == "pins");
+	debugger.remove("pins");
+	CHECK(Serial.output().find("Unable to remove") == std::string::npos);
+}
+
+TEST(ids_are_stable)
+{
+	Variable watches[3];
+	ArduinoDebugger debugger(watches, true, false);
+	int a = 1;
+	int b = 2;
+	int c = 3;
+	int d = 4;
+	CHECK_EQUAL(0, debugger.add(a, "a"));
+	CHECK_EQUAL(1, debugger.add(b, "b"));
+	CHECK_EQUAL(2, debugger.add(c, "c"));
+	CHECK_EQUAL(DEBUG_NO_WATCH, debugger.add(d, "d"));
+	debugger.removeWatch(0);
+	CHECK_EQUAL(DEBUG_NO_WATCH, debugger.find("a"));
+	CHECK_EQUAL(2, debugger.find("c"));
+	CHECK_EQUAL(0, debugger.add(d, "d"));//Takes the free slot
+	CHECK_EQUAL(1, debugger.add(b, "b"));//Already watched
+}
+
+TEST(re_adding_moves_the_watch)
+{
+	Variable watches[2];
+	ArduinoDebugger debugger(watches, true, false);
+	for(int pass = 0; pass < 3; pass++)
+	{
+		int local = pass;
+		CHECK_EQUAL(0, debugger.add(local, "local"));
+		CHECK(watches[0].ptr == &local);
+	}
+	int other = 9;
+	debugger.updateWatch(0, other);
+	CHECK(watches[0].ptr == &other);
+}
+
+TEST(compile_time_names)
+{
+	Variable watches[2];
+	ArduinoDebugger debugger(watches, true, false);
+	int count = 12;
+	static_assert(DebugHash<debugHash("count")>::value == debugHash("count"), "hash is a constant");
+	byte id = debugger.add(DEBUG_WATCH(count));
+	CHECK_EQUAL(0, id);
+	CHECK_EQUAL(id, debugger.find("count"));
+	CHECK_EQUAL(id, debugger.find(DEBUG_NAME("count")));
+	CHECK_EQUAL(id, debugger.add(count, "count"));
+	CHECK(debugger.setCondition("count == 12"));
+	debugger.displayVariables();
+	CHECK_OUTPUT("[0] count (int): 12");
+}
+
+TEST(removed_ids_in_protocol)
+{
+	ArduinoDebugger debugger(true, false, true);
+	int a = 1;
+	int b = 2;
+	debugger.add(a, "a");
+	debugger.add(b, "b");
+	debugger.remove("a");
+	std::vector<byte> index(1, 0);
+	sendCommand(OP_LIST_WATCHES);
+	sendCommand(OP_READ_VAR, index);
+	sendCommand(OP_CONTINUE);
+	debugger.breakpoint();
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(OP_WATCH, frames[1].opcode);
+	CHECK_EQUAL(1, frames[1].payload[0]);
+	CHECK_EQUAL(OP_ACK, frames[2].opcode);
+	CHECK_EQUAL(ERR_INDEX, frames[3].payload[0]);
+}
+
+TEST(moved_debugger_takes_the_watch_table)
+{
+	int a = 1;
+	int b = 2;
+	ArduinoDebugger* original = new ArduinoDebugger(true, false);
+	original->add(a, "a");
+	ArduinoDebugger moved(std::move(*original));
+	ArduinoDebugger second(true, false);//The built-in table is taken
+	CHECK_EQUAL(DEBUG_NO_WATCH, second.add(b, "b"));
+	CHECK_EQUAL(DEBUG_NO_WATCH, original->find((char*)"a"));
+	delete original;
+	CHECK_EQUAL(0, moved.find((char*)"a"));
+	CHECK_EQUAL(1, moved.add(b, "b"));
+	Variable watches[1];
+	ArduinoDebugger own(watches, true, false);
+	CHECK_EQUAL(0, own.add(b, "b"));
+}
+
+TEST(add_again_takes_the_new_type_and_length)
+{
+	ArduinoDebugger debugger(true, false, true);
+	int short_samples[2] = {1, 2};
+	long long_samples[3] = {3, 4, 5};
+	byte id = debugger.add(short_samples, "samples");
+	byte start = debugger.generation();
+	CHECK_EQUAL(id, debugger.add(short_samples, "samples"));
+	CHECK_EQUAL(start, debugger.generation());
+	CHECK_EQUAL(id, debugger.add(long_samples, "samples"));
+	CHECK(debugger.generation() != start);
+	std::vector<byte> index(1, id);
+	sendCommand(OP_READ_VAR, index);
+	debugger.poll();
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(OP_VALUE, frames[0].opcode);
+	CHECK_EQUAL(3 + 3 * sizeof(long), frames[0].payload.size());
+	CHECK_EQUAL(3, frames[0].payload[3]);
+}
+
+TEST(update_watch_checks_the_type_and_length)
+{
+	ArduinoDebugger debugger(true, false);
+	int levels[4] = {0};
+	int other[4] = {0};
+	int fewer[3] = {0};
+	long wider[4] = {0};
+	int single = 0;
+	byte id = debugger.add(levels, "levels");
+	CHECK(debugger.updateWatch(id, other));
+	CHECK(!debugger.updateWatch(id, fewer));
+	CHECK(!debugger.updateWatch(id, wider));
+	CHECK(!debugger.updateWatch(id, single));
+	CHECK(!debugger.updateWatch(DEBUG_NO_WATCH, other));
+}
@@ -0,0 +1,132 @@
+//Data watchpoints tested by check()
+#include "TestHarness.h"
+#include <ArduinoDebugger.h>
+
+TEST(watchpoint_halts_when_value_changes)
+{
+	ArduinoDebugger debugger(true, false);
+	int speed = 3;
+	byte id = debugger.add(speed, "speed");
+	CHECK(debugger.watchpoint(id));
+	debugger.check();
+	CHECK(Serial.output().empty());
+	speed = 4;
+	Serial.feed("q\n");
+	debugger.check();
+	CHECK_OUTPUT("Breakpoint - speed");
+	Serial.clear();
+	debugger.check();
+	CHECK(Serial.output().empty());
+}
+
+TEST(watchpoint_halts_while_profiling)
+{
+	ArduinoDebugger debugger(true, false);
+	int speed = 3;
+	int load = 5;
+	debugger.watchpoint(debugger.add(speed, "speed"));
+	debugger.watchpoint(debugger.add(load, "load"));
+	Probe probes[2];
+	debugger.profileBegin(probes);
+	debugger.check();
+	speed = 4;
+	Serial.feed("q\n");
+	debugger.check();
+	CHECK_OUTPUT("Breakpoint - speed");
+	load = 6;
+	Serial.feed("q\n");
+	debugger.check();
+	CHECK_OUTPUT("Breakpoint - load");
+	debugger.profileEnd();
+	Serial.clear();
+	debugger.displayProfile();
+	CHECK(Serial.output().find("speed :") == std::string::npos);
+	CHECK(Serial.output().find("load :") == std::string::npos);
+}
+
+TEST(watchpoint_on_an_array)
+{
+	ArduinoDebugger debugger(true, false);
+	int table[32] = {0};
+	byte id = debugger.add(table, "table");
+	debugger.watchpoint(id);
+	debugger.check();
+	CHECK(Serial.output().empty());
+	table[20] = 1;
+	Serial.feed("q\n");
+	debugger.check();
+	CHECK_OUTPUT("Breakpoint - table");
+}
+
+TEST(watchpoint_fires_when_crossing_threshold)
+{
+	ArduinoDebugger debugger(true, false);
+	int level = 150;
+	debugger.add(level, "level");
+	CHECK(debugger.watchpointIf("level > 100"));
+	debugger.check();
+	CHECK(Serial.output().empty());//Already past the threshold when set
+	level = 50;
+	debugger.check();
+	level = 101;
+	Serial.feed("q\n");
+	debugger.check();
+	CHECK_OUTPUT("Breakpoint - level");
+	Serial.clear();
+	level = 120;
+	debugger.check();
+	CHECK(Serial.output().empty());
+	CHECK(!debugger.watchpointIf("level >"));
+	CHECK(!debugger.watchpointIf("missing > 1"));
+}
+
+TEST(watchpoint_records_trace)
+{
+	ArduinoDebugger debugger(true, false);
+	long total = 0;
+	byte buffer[128];
+	byte id = debugger.add(total, "total");
+	debugger.traceBegin(buffer, sizeof(buffer), 1UL << id);
+	debugger.watchpoint(id, WATCH_TRACE);
+	for(int i = 0; i < 10; i++)
+	{
+		total += (i % 2);//Changes on every other pass
+		debugger.check();
+	}
+	CHECK(Serial.output().empty());
+	sendCommand(OP_DUMP_TRACE);
+	debugger.poll();
+	std::vector<Frame> frames = receivedFrames();
+	CHECK_EQUAL(OP_TRACE, frames[0].opcode);
+	CHECK_EQUAL(5, frames[0].payload[2]);
+}
+
+TEST(removing_a_watch_drops_its_watchpoints)
+{
+	ArduinoDebugger debugger(true, false);
+	int a = 1;
+	byte id = debugger.add(a, "a");
+	debugger.watchpoint(id);
+	debugger.removeWatch(id);
+	a = 2;
+	debugger.check();
+	CHECK(Serial.output().empty());
+	for(int i = 0; i < DEBUG_WATCHPOINTS; i++)
+	{
+		CHECK(debugger.watchpointIf("a == 3") == false);
+	}
+}
+
+TEST(watchpoint_table_is_limited)
+{
+	ArduinoDebugger debugger(true, false);
+	int a = 1;
+	byte id = debugger.add(a, "a");
+	for(int i = 0; i < DEBUG_WATCHPOINTS; i++)
+	{
+		CHECK(debugger.watchpoint(id));
+	}
+	CHECK(!debugger.watchpoint(id));
+	debugger.clearWatchpoints();
+	CHECK(debugger.watchpoint(id));
+}
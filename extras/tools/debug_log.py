@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+"""Decode the log frames sent by DebugLog.h.
+
+The board only sends each message's id and the raw bytes of its arguments.
+The id is the same hash the library works out at compile time (debugHash()
+of "<level>:<format>"), so the table of messages can be rebuilt from the
+sketch's source:
+
+    debug_log.py table MySketch.ino --int-size 2 -o messages.json
+    debug_log.py decode messages.json --port /dev/ttyUSB0
+    debug_log.py decode messages.json --file capture.bin
+
+Arguments are sent as their own C++ type, so each conversion must say how
+big its argument is: %d/%u/%x int, %ld long, %hd short, %hhd/%hhu/%c a
+single byte (byte, char & bool), %f float, %lf double, %s text.
+Bytes that aren't log frames (Ex: the debugger's text menus) are passed
+through unchanged.
+"""
+import argparse
+import json
+import re
+import struct
+import sys
+
+FRAME_SYNC = 0xA5
+OP_LOG = 0x4A
+LEVELS = {"ERROR": "E", "WARN": "W", "INFO": "I", "DEBUG": "D"}
+
+CALL = re.compile(r'DEBUG_LOG_(ERROR|WARN|INFO|DEBUG)\s*\(\s*((?:"(?:[^"\\]|\\.)*"\s*)+)')
+LITERAL = re.compile(r'"((?:[^"\\]|\\.)*)"')
+CONVERSION = re.compile(r'%([-+ #0]*)(\d+)?(?:\.(\d+))?(hh|h|ll|l)?([diouxXcfeEgGs%])')
+ESCAPES = {"n": "\n", "t": "\t", "r": "\r", "\\": "\\", '"': '"', "'": "'", "0": "\0"}
+
+
+def debug_hash(text):
+    """Same as debugHash() in ArduinoDebugger.h."""
+    value = 5381
+    for c in text.encode("latin-1"):
+        value = ((value * 33) ^ c) & 0xFFFF
+    return value
+
+
+def unescape(literal):
+    def replace(match):
+        code = match.group(1)
+        if code.startswith("x"):
+            return chr(int(code[1:], 16))
+        return ESCAPES.get(code, code)
+    return re.sub(r'\\(x[0-9a-fA-F]{1,2}|.)', replace, literal)
+
+
+def build_table(sources, int_size, long_size):
+    messages = {}
+    for path in sources:
+        with open(path, encoding="utf-8", errors="replace") as source:
+            text = source.read()
+        for call in CALL.finditer(text):
+            level = LEVELS[call.group(1)]
+            form = "".join(unescape(part) for part in LITERAL.findall(call.group(2)))
+            key = str(debug_hash(level + ":" + form))
+            line = text.count("\n", 0, call.start()) + 1
+            entry = {"level": level, "format": form, "file": path, "line": line}
+            if key in messages and messages[key]["format"] != form:
+                sys.stderr.write("warning: %s:%d shares id %s with %s:%d\n" % (
+                    path, line, key, messages[key]["file"], messages[key]["line"]))
+            messages.setdefault(key, entry)
+    return {"int_size": int_size, "long_size": long_size, "messages": messages}
+
+
+def argument_size(length, conversion, sizes):
+    if conversion in "feEgG":
+        return 8 if length in ("l", "ll") else 4
+    if conversion == "c" or length == "hh":
+        return 1
+    if length == "h":
+        return 2
+    if length == "ll":
+        return 8
+    if length == "l":
+        return sizes["long_size"]
+    return sizes["int_size"]
+
+
+def format_message(form, data, sizes):
+    """Rebuild the text of one message, None if the bytes don't match the format."""
+    out = []
+    position = 0
+    last = 0
+    for match in CONVERSION.finditer(form):
+        out.append(form[last:match.start()])
+        last = match.end()
+        flags, width, precision, length, conversion = match.groups()
+        if conversion == "%":
+            out.append("%")
+            continue
+        spec = "%" + flags + (width or "") + ("." + precision if precision else "")
+        if conversion == "s":
+            end = data.find(b"\0", position)
+            if end < 0:
+                return None
+            out.append((spec + "s") % data[position:end].decode("latin-1"))
+            position = end + 1
+            continue
+        size = argument_size(length, conversion, sizes)
+        raw = data[position:position + size]
+        if len(raw) != size:
+            return None
+        position += size
+        if conversion in "feEgG":
+            value = struct.unpack("<f" if size == 4 else "<d", raw)[0]
+        elif conversion == "c":
+            out.append((spec + "c") % chr(raw[0]))
+            continue
+        else:
+            value = int.from_bytes(raw, "little", signed=conversion in "di")
+        out.append((spec + conversion) % value)
+    out.append(form[last:])
+    if position != len(data):
+        return None
+    return "".join(out)
+
+
+def decode(table, stream, output):
+    messages = table["messages"]
+    buffer = bytearray()
+    while True:
+        chunk = stream.read(1)
+        if not chunk:
+            break
+        buffer += chunk
+        while buffer:
+            if buffer[0] != FRAME_SYNC:
+                output.write(chr(buffer.pop(0)))
+                continue
+            if len(buffer) < 3 or len(buffer) < buffer[1] + 4:
+                break  # Wait for the rest of the frame
+            length = buffer[1]
+            frame = buffer[:length + 4]
+            if sum(frame[1:]) & 0xFF != 0 or frame[2] != OP_LOG or length < 2:
+                output.write(chr(buffer.pop(0)))  # Not a log frame, pass the byte on
+                continue
+            del buffer[:length + 4]
+            payload = bytes(frame[3:3 + length])
+            key = str(payload[0] | (payload[1] << 8))
+            entry = messages.get(key)
+            text = None if entry is None else format_message(entry["format"], payload[2:], table)
+            if text is None:
+                output.write("[?] id %s: %s\n" % (key, payload[2:].hex()))
+            else:
+                output.write("[%s] %s:%d %s\n" % (entry["level"], entry["file"], entry["line"], text))
+        output.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    commands = parser.add_subparsers(dest="command", required=True)
+    table = commands.add_parser("table", help="build the message table from the sketch's source")
+    table.add_argument("sources", nargs="+")
+    table.add_argument("--int-size", type=int, default=2, help="sizeof(int) on the board (2 on AVR, 4 on ARM)")
+    table.add_argument("--long-size", type=int, default=4, help="sizeof(long) on the board (4 on AVR & ARM)")
+    table.add_argument("-o", "--output", default="-")
+    decoder = commands.add_parser("decode", help="turn log frames back into text")
+    decoder.add_argument("table")
+    source = decoder.add_mutually_exclusive_group()
+    source.add_argument("--port", help="serial port (needs pyserial)")
+    source.add_argument("--file", help="captured bytes, stdin if neither is given")
+    decoder.add_argument("--baud", type=int, default=9600)
+    args = parser.parse_args()
+
+    if args.command == "table":
+        result = json.dumps(build_table(args.sources, args.int_size, args.long_size), indent=1)
+        if args.output == "-":
+            print(result)
+        else:
+            with open(args.output, "w") as output:
+                output.write(result + "\n")
+        return
+    with open(args.table) as table_file:
+        messages = json.load(table_file)
+    if args.port:
+        import serial
+        stream = serial.Serial(args.port, args.baud)
+    elif args.file:
+        stream = open(args.file, "rb")
+    else:
+        stream = sys.stdin.buffer
+    decode(messages, stream, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()